@@ -103,6 +103,9 @@
 #define SIP_SSIP			MIP_SSIP
 #define SIP_STIP			MIP_STIP
 
+#define MTVEC_MODE_DIRECT		_UL(0)
+#define MTVEC_MODE_VECTORED		_UL(1)
+
 #define PRV_U				_UL(0)
 #define PRV_S				_UL(1)
 #define PRV_M				_UL(3)
@@ -636,12 +639,16 @@
 #define INSN_MATCH_SD			0x3023
 #define INSN_MASK_SD			0x707f
 
+#define INSN_MATCH_FLH			0x1007
+#define INSN_MASK_FLH			0x707f
 #define INSN_MATCH_FLW			0x2007
 #define INSN_MASK_FLW			0x707f
 #define INSN_MATCH_FLD			0x3007
 #define INSN_MASK_FLD			0x707f
 #define INSN_MATCH_FLQ			0x4007
 #define INSN_MASK_FLQ			0x707f
+#define INSN_MATCH_FSH			0x1027
+#define INSN_MASK_FSH			0x707f
 #define INSN_MATCH_FSW			0x2027
 #define INSN_MASK_FSW			0x707f
 #define INSN_MATCH_FSD			0x3027
@@ -693,10 +700,14 @@
 #define MATCH_FCLASS_S          0xe0001053
 #define MATCH_FMV_X_D           0xe2000053
 #define MATCH_FCLASS_D          0xe2001053
+#define MATCH_FMV_X_H           0xe4000053
+#define MATCH_FCLASS_H          0xe4001053
 #define MASK_FMV_W_X            0xfff0707f
 #define MATCH_FMV_W_X           0xf0000053
 #define MASK_FMV_D_X            0xfff0707f
 #define MATCH_FMV_D_X           0xf2000053
+#define MASK_FMV_H_X            0xfff0707f
+#define MATCH_FMV_H_X           0xf4000053
 
 #define INSN_IS_16BIT(insn)		\
 	(((insn) & INSN_16BIT_MASK) != INSN_16BIT_MASK)
@@ -19,6 +19,18 @@ struct sbi_console_device {
 	/** Write a character to the console output */
 	void (*console_putc)(char ch);
 
+	/**
+	 * Write a character string to the console output (optional).
+	 * Newlines are passed through unchanged.
+	 */
+	void (*console_puts)(const char *str, size_t len);
+
+	/**
+	 * Number of bytes the console output can take without waiting
+	 * (optional, needed for buffered output)
+	 */
+	unsigned long (*console_tx_room)(void);
+
 	/** Read a character from the console input */
 	int (*console_getc)(void);
 };
@@ -33,8 +45,12 @@ void sbi_putc(char ch);
 
 void sbi_puts(const char *str);
 
+unsigned long sbi_nputs(const char *str, unsigned long len);
+
 void sbi_gets(char *s, int maxwidth, char endchar);
 
+unsigned long sbi_ngets(char *str, unsigned long len);
+
 int __printf(2, 3) sbi_sprintf(char *out, const char *format, ...);
 
 int __printf(3, 4) sbi_snprintf(char *out, u32 out_sz, const char *format, ...);
@@ -49,6 +65,16 @@ const struct sbi_console_device *sbi_console_get_device(void);
 
 void sbi_console_set_device(const struct sbi_console_device *dev);
 
+#ifdef SBI_CONSOLE_ASYNC_SIZE
+void sbi_console_drain(void);
+
+void sbi_console_flush(void);
+#else
+static inline void sbi_console_drain(void) { }
+
+static inline void sbi_console_flush(void) { }
+#endif
+
 struct sbi_scratch;
 
 int sbi_console_init(struct sbi_scratch *scratch);
@@ -40,6 +40,8 @@ extern struct sbi_ecall_extension ecall_vendor;
 extern struct sbi_ecall_extension ecall_hsm;
 extern struct sbi_ecall_extension ecall_srst;
 extern struct sbi_ecall_extension ecall_pmu;
+extern struct sbi_ecall_extension ecall_dbcn;
+extern struct sbi_ecall_extension ecall_fp_emul;
 
 u16 sbi_ecall_version_major(void);
 
@@ -29,6 +29,9 @@
 #define SBI_EXT_HSM				0x48534D
 #define SBI_EXT_SRST				0x53525354
 #define SBI_EXT_PMU				0x504D55
+#define SBI_EXT_DBCN				0x4442434E
+/* Firmware specific, within SBI_EXT_FIRMWARE_START..SBI_EXT_FIRMWARE_END */
+#define SBI_EXT_FP_EMUL				0x0A465045
 
 /* SBI function IDs for BASE extension*/
 #define SBI_EXT_BASE_GET_SPEC_VERSION		0x0
@@ -100,6 +103,20 @@
 #define SBI_EXT_PMU_COUNTER_STOP	0x4
 #define SBI_EXT_PMU_COUNTER_FW_READ	0x5
 
+/* SBI function IDs for DBCN extension */
+#define SBI_EXT_DBCN_CONSOLE_WRITE		0x0
+#define SBI_EXT_DBCN_CONSOLE_READ		0x1
+#define SBI_EXT_DBCN_CONSOLE_WRITE_BYTE		0x2
+
+/* SBI function IDs for FP_EMUL extension */
+#define SBI_EXT_FP_EMUL_GET_FS		0x0
+#define SBI_EXT_FP_EMUL_SAVE		0x1
+#define SBI_EXT_FP_EMUL_RESTORE		0x2
+
+#define SBI_FP_EMUL_FLAG_Q		(1 << 0)
+
+#ifndef __ASSEMBLER__
+
 /** General pmu event codes specified in SBI PMU extension */
 enum sbi_pmu_hw_generic_events_t {
 	SBI_PMU_HW_NO_EVENT			= 0,
@@ -182,6 +199,30 @@ enum sbi_pmu_fw_event_code_id {
 	SBI_PMU_FW_HFENCE_VVMA_ASID_SENT = 20,
 	SBI_PMU_FW_HFENCE_VVMA_ASID_RCVD = 21,
 	SBI_PMU_FW_MAX,
+
+	/*
+	 * Event codes up to 255 are reserved for standard events. Codes
+	 * from 256 on are specific to OpenSBI.
+	 */
+	SBI_PMU_FW_IMPL_BASE		= 256,
+	SBI_PMU_FW_FP_EMUL_RUN		= SBI_PMU_FW_IMPL_BASE,
+	SBI_PMU_FW_FP_EMUL_INSN		= 257,
+	SBI_PMU_FW_FP_EMUL_ADD		= 258,
+	SBI_PMU_FW_FP_EMUL_MUL		= 259,
+	SBI_PMU_FW_FP_EMUL_DIV		= 260,
+	SBI_PMU_FW_FP_EMUL_SQRT		= 261,
+	SBI_PMU_FW_FP_EMUL_FMA		= 262,
+	SBI_PMU_FW_FP_EMUL_CVT		= 263,
+	SBI_PMU_FW_FP_EMUL_CMP		= 264,
+	SBI_PMU_FW_FP_EMUL_MOVE		= 265,
+	SBI_PMU_FW_FP_EMUL_LOAD		= 266,
+	SBI_PMU_FW_FP_EMUL_STORE	= 267,
+	SBI_PMU_FW_FP_EMUL_CYCLES	= 268,
+	SBI_PMU_FW_RFENCE_MERGE_ALL	= 269,
+	SBI_PMU_FW_RFENCE_MERGE_GLOBAL	= 270,
+	SBI_PMU_FW_RFENCE_MERGE_RANGE	= 271,
+	SBI_PMU_FW_RFENCE_MERGE_FENCE_I	= 272,
+	SBI_PMU_FW_IMPL_MAX,
 };
 
 /** SBI PMU event idx type */
@@ -199,6 +240,8 @@ enum sbi_pmu_ctr_type {
 	SBI_PMU_CTR_TYPE_FW,
 };
 
+#endif
+
 /* Helper macros to decode event idx */
 #define SBI_PMU_EVENT_IDX_OFFSET 20
 #define SBI_PMU_EVENT_IDX_MASK 0xFFFFF
@@ -228,6 +271,8 @@ enum sbi_pmu_ctr_type {
 #define SBI_SPEC_VERSION_MAJOR_OFFSET		24
 #define SBI_SPEC_VERSION_MAJOR_MASK		0x7f
 #define SBI_SPEC_VERSION_MINOR_MASK		0xffffff
+#define SBI_EXT_EXPERIMENTAL_START		0x08000000
+#define SBI_EXT_EXPERIMENTAL_END		0x08FFFFFF
 #define SBI_EXT_VENDOR_START			0x09000000
 #define SBI_EXT_VENDOR_END			0x09FFFFFF
 #define SBI_EXT_FIRMWARE_START			0x0A000000
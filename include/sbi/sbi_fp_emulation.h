@@ -10,25 +10,57 @@
 #ifndef __SBI_FP_EMULATION_H__
 #define __SBI_FP_EMULATION_H__
 
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_fp_qreg.h>
 #include <sbi/sbi_trap.h>
 
 #define GET_PRECISION(insn) (((insn) >> 25) & 3)
 #define GET_RM(insn) (((insn) >> 12) & 7)
 #define PRECISION_S 0
 #define PRECISION_D 1
+#define PRECISION_H 2
+#define PRECISION_Q 3
 
+#ifdef SBI_FP_EMULATION_HOST
+/*
+ * Host builds of the emulation routines (such as a benchmark or
+ * conformance harness) keep the emulated FCSR in a variable instead of
+ * the TP register.
+ */
+extern long tp;
+# define SET_FCSR(value, regs) ({ tp = (value) & 0xFF; SET_FS_DIRTY(regs); })
+# define softfloat_raiseFlags(which) ({ tp |= (which); })
+#else
 register long tp asm("tp");
+# define SET_FCSR(value, regs) ({ asm volatile("add tp, x0, %0" :: "rI"((value) & 0xFF)); SET_FS_DIRTY(regs); })
+# define softfloat_raiseFlags(which) ({ asm volatile ("or tp, tp, %0" :: "rI"(which)); })
+#endif
+
+/* MSTATUS is restored from the trap frame when returning to S/U-mode */
+# define SET_FS_DIRTY(regs) ((regs)->mstatus |= MSTATUS_FS)
 
-# define GET_F64_REG(insn, pos, regs) (*(int64_t*)((void*)((regs) + SBI_TRAP_REGS_last) + (SHIFT_RIGHT(insn, (pos)-3) & 0xf8)))
+/* The 32 emulated FP registers follow struct sbi_trap_regs in the trap frame */
+# define GET_FP_REGS(regs) ((int64_t *)((void *)(regs) + SBI_TRAP_REGS_OFFSET(last)))
+# define GET_F64_REG(insn, pos, regs) (GET_FP_REGS(regs)[SHIFT_RIGHT(insn, pos) & 0x1f])
 # define SET_F64_REG(insn, pos, regs, val) (GET_F64_REG(insn, pos, regs) = (val))
 # define GET_F32_REG(insn, pos, regs) (*(int32_t*)&GET_F64_REG(insn, pos, regs))
-# define SET_F32_REG(insn, pos, regs, val) (GET_F32_REG(insn, pos, regs) = (val))
+/* Single-precision values are NaN-boxed when RV64 has the D extension */
+# define SET_F32_REG(insn, pos, regs, val) (GET_F64_REG(insn, pos, regs) = (int64_t)(0xFFFFFFFF00000000ULL | (uint32_t)(val)))
+/* Half-precision values must be NaN-boxed, otherwise they read as the canonical NaN */
+# define GET_F16_REG(insn, pos, regs) ({ int64_t __v = GET_F64_REG(insn, pos, regs); (uint16_t)((__v >> 16) == -1 ? __v : 0x7E00); })
+# define SET_F16_REG(insn, pos, regs, val) (GET_F64_REG(insn, pos, regs) = (int64_t)(0xFFFFFFFFFFFF0000ULL | (uint16_t)(val)))
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+/* The high half of a 128-bit register, narrower values NaN-box it */
+# define GET_FQ_HI(insn, pos) (sbi_fp_qreg_hi()[((insn) >> (pos)) & 0x1f])
+# define SET_FQ_BOXED(insn, pos) (GET_FQ_HI(insn, pos) = -1ULL)
+#else
+# define SET_FQ_BOXED(insn, pos) ((void)0)
+#endif
 # define GET_FCSR() ({ (int)tp & 0xFF; })
-# define SET_FCSR(value) ({ asm volatile("add tp, x0, %0" :: "rI"((value) & 0xFF)); SET_FS_DIRTY(); })
 # define GET_FRM() (GET_FCSR() >> 5)
-# define SET_FRM(value) SET_FCSR(GET_FFLAGS() | ((value) << 5))
+# define SET_FRM(value, regs) SET_FCSR(GET_FFLAGS() | ((value) << 5), regs)
 # define GET_FFLAGS() (GET_FCSR() & 0x1F)
-# define SET_FFLAGS(value) SET_FCSR((GET_FRM() << 5) | ((value) & 0x1F))
+# define SET_FFLAGS(value, regs) SET_FCSR((GET_FRM() << 5) | ((value) & 0x1F), regs)
 
 # define SETUP_STATIC_ROUNDING(insn) ({ \
   tp &= 0xFF; \
@@ -38,18 +70,30 @@ register long tp asm("tp");
   asm volatile ("":"+r"(tp)); })
 
 
-# define softfloat_raiseFlags(which) ({ asm volatile ("or tp, tp, %0" :: "rI"(which)); })
 # define softfloat_roundingMode ({ (int)tp >> 13; })
-# define SET_FS_DIRTY() csr_read_set(CSR_MSTATUS, MSTATUS_FS)
 
+#define GET_F16_RS1(insn, regs) (GET_F16_REG(insn, 15, regs))
+#define GET_F16_RS2(insn, regs) (GET_F16_REG(insn, 20, regs))
+#define GET_F16_RS3(insn, regs) (GET_F16_REG(insn, 27, regs))
 #define GET_F32_RS1(insn, regs) (GET_F32_REG(insn, 15, regs))
 #define GET_F32_RS2(insn, regs) (GET_F32_REG(insn, 20, regs))
 #define GET_F32_RS3(insn, regs) (GET_F32_REG(insn, 27, regs))
 #define GET_F64_RS1(insn, regs) (GET_F64_REG(insn, 15, regs))
 #define GET_F64_RS2(insn, regs) (GET_F64_REG(insn, 20, regs))
 #define GET_F64_RS3(insn, regs) (GET_F64_REG(insn, 27, regs))
-#define SET_F32_RD(insn, regs, val) (SET_F32_REG(insn, 7, regs, val), SET_FS_DIRTY())
-#define SET_F64_RD(insn, regs, val) (SET_F64_REG(insn, 7, regs, val), SET_FS_DIRTY())
+#define SET_F16_RD(insn, regs, val) (SET_F16_REG(insn, 7, regs, val), SET_FQ_BOXED(insn, 7), SET_FS_DIRTY(regs))
+#define SET_F32_RD(insn, regs, val) (SET_F32_REG(insn, 7, regs, val), SET_FQ_BOXED(insn, 7), SET_FS_DIRTY(regs))
+#define SET_F64_RD(insn, regs, val) (SET_F64_REG(insn, 7, regs, val), SET_FQ_BOXED(insn, 7), SET_FS_DIRTY(regs))
+
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+# define GET_F128_REG(insn, pos, regs) ({ float128_t __q; \
+  __q.v[0] = GET_F64_REG(insn, pos, regs); __q.v[1] = GET_FQ_HI(insn, pos); __q; })
+# define SET_F128_RD(insn, regs, val) ({ float128_t __q = (val); \
+  SET_F64_REG(insn, 7, regs, __q.v[0]); GET_FQ_HI(insn, 7) = __q.v[1]; SET_FS_DIRTY(regs); })
+#define GET_F128_RS1(insn, regs) (GET_F128_REG(insn, 15, regs))
+#define GET_F128_RS2(insn, regs) (GET_F128_REG(insn, 20, regs))
+#define GET_F128_RS3(insn, regs) (GET_F128_REG(insn, 27, regs))
+#endif
 
 #define GET_F32_RS2C(insn, regs) (GET_F32_REG(insn, 2, regs))
 #define GET_F32_RS2S(insn, regs) (GET_F32_REG(RVC_RS2S(insn), 0, regs))
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __SBI_FP_KERNELS_H__
+#define __SBI_FP_KERNELS_H__
+
+#include <sbi_utils/softfloat/softfloat.h>
+
+/*
+ * Drop-in replacements for the softfloat routines of the same name which
+ * handle normal operands with integer-only kernels and fall back to
+ * softfloat for everything else. Add and mul take the fast path under
+ * round-to-nearest-even only, div and sqrt under all IEEE rounding modes.
+ * Results and raised exception flags are identical to softfloat.
+ *
+ * The double-precision div and sqrt kernels are only built with
+ * SBI_ENABLE_FP_FAST_F64_DIV_SQRT, as they did not beat softfloat on the
+ * hosts measured. Otherwise they are softfloat.
+ */
+float32_t fp_fast_f32_add(float32_t a, float32_t b);
+float32_t fp_fast_f32_mul(float32_t a, float32_t b);
+float32_t fp_fast_f32_div(float32_t a, float32_t b);
+float32_t fp_fast_f32_sqrt(float32_t a);
+float64_t fp_fast_f64_add(float64_t a, float64_t b);
+float64_t fp_fast_f64_mul(float64_t a, float64_t b);
+#ifdef SBI_ENABLE_FP_FAST_F64_DIV_SQRT
+float64_t fp_fast_f64_div(float64_t a, float64_t b);
+float64_t fp_fast_f64_sqrt(float64_t a);
+#else
+static inline float64_t fp_fast_f64_div(float64_t a, float64_t b)
+{
+	return f64_div(a, b);
+}
+
+static inline float64_t fp_fast_f64_sqrt(float64_t a)
+{
+	return f64_sqrt(a);
+}
+#endif
+
+#endif
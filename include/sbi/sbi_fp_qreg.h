@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __SBI_FP_QREG_H__
+#define __SBI_FP_QREG_H__
+
+#include <sbi/sbi_types.h>
+
+struct sbi_scratch;
+
+/*
+ * With quad-precision emulation, the emulated FP registers are 128-bit
+ * wide. The low 64 bits of each register stay in the trap frame, the high
+ * 64 bits live in a per-HART bank in scratch space.
+ */
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION) && \
+    defined(SBI_ENABLE_FP_EMULATION_Q)
+u64 *sbi_fp_qreg_hi(void);
+
+int sbi_fp_qreg_init(struct sbi_scratch *scratch, bool cold_boot);
+#else
+static inline int sbi_fp_qreg_init(struct sbi_scratch *scratch,
+				   bool cold_boot)
+{
+	return 0;
+}
+#endif
+
+#endif
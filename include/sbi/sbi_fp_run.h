@@ -0,0 +1,27 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __SBI_FP_RUN_H__
+#define __SBI_FP_RUN_H__
+
+#include <sbi/sbi_types.h>
+
+struct sbi_scratch;
+struct sbi_trap_regs;
+
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+int sbi_fp_emulate_run(ulong insn, struct sbi_trap_regs *regs, ulong unsaved);
+
+int sbi_fp_icache_init(struct sbi_scratch *scratch, bool cold_boot);
+#else
+static inline int sbi_fp_icache_init(struct sbi_scratch *scratch,
+				     bool cold_boot)
+{
+	return 0;
+}
+#endif
+
+#endif
@@ -21,8 +21,28 @@ int sbi_illegal_insn_handler(ulong insn, ulong tval2, ulong tinst,
 
 int truly_illegal_insn(ulong insn, struct sbi_trap_regs *regs);
 
+struct sbi_trap_regs *sbi_fp_trap_handler(ulong insn,
+					  struct sbi_trap_regs *regs);
+
+int system_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
+
+int emulate_rvc(ulong insn, ulong tval2, ulong tinst,
+		struct sbi_trap_regs *regs);
+
+int fmadd_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
+
+int float_load_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
+
+int float_store_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
+
+illegal_insn_func fp_opcode_decode(ulong insn);
+
+int fp_opcode_exec(illegal_insn_func f, ulong insn, struct sbi_trap_regs *regs);
+
+int fp_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
+
 #define punt_to_misaligned_handler(align, handler) \
 	if (addr % (align) != 0)                   \
-	return csr_write(CSR_MTVAL, addr), (handler)(insn, tval2, tinst, regs)
+	return (handler)(addr, tval2, tinst, regs)
 
 #endif
@@ -47,9 +47,9 @@ struct sbi_ipi_event_ops {
 			u32 remote_hartid, void *data);
 
 	/**
-	 * Sync callback to wait for remote HART
-	 * Note: This is an optional callback and it is called just after
-	 * triggering IPI to remote HART.
+	 * Sync callback to wait for remote HARTs
+	 * Note: This is an optional callback and it is called once after
+	 * triggering IPI to all remote HARTs.
 	 */
 	void (* sync)(struct sbi_scratch *scratch);
 
@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __SBI_MPSC_H__
+#define __SBI_MPSC_H__
+
+#include <sbi/riscv_atomic.h>
+#include <sbi/sbi_types.h>
+
+/**
+ * Bounded lock-free queue with many producers and a single consumer
+ *
+ * Each slot holds a sequence number next to the entry. A slot is free
+ * for the producer of position pos when its sequence number equals pos
+ * and holds the entry of position pos once it equals pos + 1.
+ */
+struct sbi_mpsc {
+	void *queue;
+	/** Next position reserved by a producer */
+	atomic_t tail;
+	/** Next position read by the consumer */
+	unsigned long head;
+	u16 entry_size;
+	/** Number of slots, a power of two */
+	u16 num_entries;
+};
+
+/** Bytes of queue memory needed per entry of the given size */
+#define SBI_MPSC_SLOT_SIZE(__entry_size)				\
+	(sizeof(unsigned long) +					\
+	 (((__entry_size) + sizeof(unsigned long) - 1) &		\
+	  ~(sizeof(unsigned long) - 1)))
+
+int sbi_mpsc_init(struct sbi_mpsc *mpsc, void *queue_mem, u16 entries,
+		  u16 entry_size);
+int sbi_mpsc_enqueue(struct sbi_mpsc *mpsc, const void *data);
+int sbi_mpsc_dequeue(struct sbi_mpsc *mpsc, void *data);
+
+#endif
@@ -36,7 +36,15 @@
 /** Offset of hart_index2id in struct sbi_platform */
 #define SBI_PLATFORM_HART_INDEX2ID_OFFSET (0x58 + (__SIZEOF_POINTER__ * 2))
 
+/** Let OpenSBI measure the TLB range flush limit at boot time */
+#define SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_AUTO		(~0ULL)
+
+#ifdef SBI_ENABLE_TLB_FLUSH_CALIBRATION
+#define SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT	\
+	SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_AUTO
+#else
 #define SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT		(1UL << 12)
+#endif
 
 #ifndef __ASSEMBLER__
 
@@ -243,8 +251,9 @@ static inline unsigned long sbi_platform_get_features(
  *
  * @param plat pointer to struct sbi_platform
  *
- * @return tlb range flush limit value. Returns a default (page size) if not
- * defined by platform.
+ * @return tlb range flush limit value. Returns a default (page size, or
+ * SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_AUTO with SBI_ENABLE_TLB_FLUSH_CALIBRATION)
+ * if not defined by platform.
  */
 static inline u64 sbi_platform_tlbr_flush_limit(const struct sbi_platform *plat)
 {
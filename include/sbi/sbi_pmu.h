@@ -20,7 +20,7 @@
 #define SBI_PMU_HW_EVENT_MAX 64
 
 /* Maximum number of firmware events that can mapped by OpenSBI */
-#define SBI_PMU_FW_EVENT_MAX 32
+#define SBI_PMU_FW_EVENT_MAX 64
 
 /* Counter related macros */
 #define SBI_PMU_FW_CTR_MAX 16
@@ -71,4 +71,16 @@ int sbi_pmu_ctr_cfg_match(unsigned long cidx_base, unsigned long cidx_mask,
 
 int sbi_pmu_ctr_incr_fw(enum sbi_pmu_fw_event_code_id fw_id);
 
+/**
+ * Add a value to the count of a firmware event. This is used by events
+ * which accumulate a quantity (such as cycles) instead of occurrences.
+ * @param fw_id firmware event code
+ * @param val   value to add if the event is being monitored
+ * @return 0 on success, error otherwise.
+ */
+int sbi_pmu_ctr_add_fw(enum sbi_pmu_fw_event_code_id fw_id, unsigned long val);
+
+/** Check whether a firmware event is being monitored on current HART */
+bool sbi_pmu_fw_event_started(enum sbi_pmu_fw_event_code_id fw_id);
+
 #endif
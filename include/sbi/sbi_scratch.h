@@ -36,8 +36,12 @@
 #define SBI_SCRATCH_TMP0_OFFSET			(9 * __SIZEOF_POINTER__)
 /** Offset of options member in sbi_scratch */
 #define SBI_SCRATCH_OPTIONS_OFFSET		(10 * __SIZEOF_POINTER__)
+/** Offset of mtime_addr member in sbi_scratch */
+#define SBI_SCRATCH_MTIME_ADDR_OFFSET		(11 * __SIZEOF_POINTER__)
+/** Offset of mtimecmp_addr member in sbi_scratch */
+#define SBI_SCRATCH_MTIMECMP_ADDR_OFFSET	(12 * __SIZEOF_POINTER__)
 /** Offset of extra space in sbi_scratch */
-#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(11 * __SIZEOF_POINTER__)
+#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(13 * __SIZEOF_POINTER__)
 /** Maximum size of sbi_scratch (4KB) */
 #define SBI_SCRATCH_SIZE			(0x1000)
 
@@ -71,6 +75,10 @@ struct sbi_scratch {
 	unsigned long tmp0;
 	/** Options for OpenSBI library */
 	unsigned long options;
+	/** MTIME address for the timer fast trap path (zero if disabled) */
+	unsigned long mtime_addr;
+	/** MTIMECMP address for the timer fast trap path (zero if disabled) */
+	unsigned long mtimecmp_addr;
 };
 
 /** Possible options for OpenSBI library */
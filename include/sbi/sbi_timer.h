@@ -69,6 +69,17 @@ void sbi_timer_event_start(u64 next_event);
 /** Process timer event for current HART */
 void sbi_timer_process(void);
 
+/**
+ * Set MTIME and MTIMECMP addresses of current HART used by the timer
+ * fast trap path (zero to disable it). Only for timer devices which
+ * support 64-bit MMIO accesses.
+ */
+void sbi_timer_set_fast_mmio(unsigned long mtime_addr,
+			     unsigned long mtimecmp_addr);
+
+/** Enable or disable timer fast trap path of current HART as needed */
+void sbi_timer_fast_trap_update(void);
+
 /** Get current timer device */
 const struct sbi_timer_device *sbi_timer_get_device(void);
 
@@ -30,7 +30,6 @@ struct sbi_tlb_info {
 	unsigned long asid;
 	unsigned long vmid;
 	void (*local_fn)(struct sbi_tlb_info *tinfo);
-	struct sbi_hartmask smask;
 };
 
 void sbi_tlb_local_hfence_vvma(struct sbi_tlb_info *tinfo);
@@ -41,20 +40,21 @@ void sbi_tlb_local_hfence_gvma_vmid(struct sbi_tlb_info *tinfo);
 void sbi_tlb_local_sfence_vma_asid(struct sbi_tlb_info *tinfo);
 void sbi_tlb_local_fence_i(struct sbi_tlb_info *tinfo);
 
-#define SBI_TLB_INFO_INIT(__p, __start, __size, __asid, __vmid, __lfn, __src) \
+#define SBI_TLB_INFO_INIT(__p, __start, __size, __asid, __vmid, __lfn) \
 do { \
 	(__p)->start = (__start); \
 	(__p)->size = (__size); \
 	(__p)->asid = (__asid); \
 	(__p)->vmid = (__vmid); \
 	(__p)->local_fn = (__lfn); \
-	SBI_HARTMASK_INIT_EXCEPT(&(__p)->smask, (__src)); \
 } while (0)
 
 #define SBI_TLB_INFO_SIZE		sizeof(struct sbi_tlb_info)
 
 int sbi_tlb_request(ulong hmask, ulong hbase, struct sbi_tlb_info *tinfo);
 
+unsigned long sbi_tlb_range_flush_limit(bool *calibrated);
+
 int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot);
 
 #endif
@@ -110,6 +110,9 @@
 /** Size (in bytes) of sbi_trap_info */
 #define SBI_TRAP_INFO_SIZE SBI_TRAP_INFO_OFFSET(last)
 
+/** Mask of integer registers not saved by the FP fast trap path (gp, s0-s11) */
+#define SBI_TRAP_FP_FAST_UNSAVED_REGS	0x0ffc0308
+
 #ifndef __ASSEMBLER__
 
 #include <sbi/sbi_types.h>
@@ -36,6 +36,11 @@ DECLARE_UNPRIVILEGED_LOAD_FUNCTION(u64)
 DECLARE_UNPRIVILEGED_STORE_FUNCTION(u64)
 DECLARE_UNPRIVILEGED_LOAD_FUNCTION(ulong)
 
+u64 sbi_load_misaligned(ulong addr, ulong len, struct sbi_trap_info *trap);
+
+void sbi_store_misaligned(ulong addr, ulong len, u64 val,
+			  struct sbi_trap_info *trap);
+
 ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap);
 
 #endif
@@ -13,7 +13,9 @@
  * Fix up the CPU node in the device tree
  *
  * This routine updates the "status" property of a CPU node in the device tree
- * to "disabled" if that hart is in disabled state in OpenSBI.
+ * to "disabled" if that hart is in disabled state in OpenSBI. When OpenSBI
+ * emulates floating-point instructions, it also appends the emulated
+ * extensions (Zfh) to the "riscv,isa" property of CPUs which have F.
  *
  * It is recommended that platform codes call this helper in their final_init()
  *
@@ -18,14 +18,19 @@ libsbi-objs-y += sbi_console.o
 libsbi-objs-y += sbi_domain.o
 libsbi-objs-y += sbi_ecall.o
 libsbi-objs-y += sbi_ecall_base.o
+libsbi-objs-y += sbi_ecall_dbcn.o
 libsbi-objs-y += sbi_ecall_hsm.o
 libsbi-objs-y += sbi_ecall_legacy.o
 libsbi-objs-y += sbi_ecall_pmu.o
+libsbi-objs-y += sbi_ecall_fp.o
 libsbi-objs-y += sbi_ecall_replace.o
 libsbi-objs-y += sbi_ecall_vendor.o
 libsbi-objs-y += sbi_emulate_csr.o
 libsbi-objs-y += sbi_fifo.o
 libsbi-objs-y += sbi_fp_emulation.o
+libsbi-objs-y += sbi_fp_kernels.o
+libsbi-objs-y += sbi_fp_qreg.o
+libsbi-objs-y += sbi_fp_run.o
 libsbi-objs-y += sbi_hart.o
 libsbi-objs-y += sbi_math.o
 libsbi-objs-y += sbi_hfence.o
@@ -34,6 +39,7 @@ libsbi-objs-y += sbi_illegal_insn.o
 libsbi-objs-y += sbi_init.o
 libsbi-objs-y += sbi_ipi.o
 libsbi-objs-y += sbi_misaligned_ldst.o
+libsbi-objs-y += sbi_mpsc.o
 libsbi-objs-y += sbi_platform.o
 libsbi-objs-y += sbi_pmu.o
 libsbi-objs-y += sbi_scratch.o
@@ -12,6 +12,7 @@
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
 
 static const struct sbi_console_device *console_dev = NULL;
 static spinlock_t console_out_lock	       = SPIN_LOCK_INITIALIZER;
@@ -32,25 +33,172 @@ int sbi_getc(void)
 	return -1;
 }
 
-void sbi_putc(char ch)
+static void console_write(const char *str, unsigned long len)
+{
+	unsigned long i;
+
+	if (console_dev->console_puts) {
+		console_dev->console_puts(str, len);
+	} else if (console_dev->console_putc) {
+		for (i = 0; i < len; i++)
+			console_dev->console_putc(str[i]);
+	}
+}
+
+#ifdef SBI_CONSOLE_ASYNC_SIZE
+
+#if SBI_CONSOLE_ASYNC_SIZE & (SBI_CONSOLE_ASYNC_SIZE - 1)
+#error "SBI_CONSOLE_ASYNC_SIZE must be a power of two"
+#endif
+
+/*
+ * Output ring shared by all HARTs and protected by console_out_lock.
+ * The head and tail indices run freely and are masked on access. The
+ * timer fast trap path reads them to leave a non-empty ring to the full
+ * trap path.
+ */
+static char console_ring[SBI_CONSOLE_ASYNC_SIZE];
+unsigned long console_ring_head;
+unsigned long console_ring_tail;
+
+static bool console_ring_enabled(void)
 {
-	if (console_dev && console_dev->console_putc) {
+	return console_dev && console_dev->console_tx_room;
+}
+
+/*
+ * Write queued output until at most keep bytes are left. Without wait,
+ * stop as soon as the device cannot take more bytes immediately.
+ */
+static void console_ring_drain(unsigned long keep, bool wait)
+{
+	unsigned long pos, len, room;
+
+	while (keep < console_ring_head - console_ring_tail) {
+		room = console_dev->console_tx_room();
+		if (!room) {
+			if (!wait)
+				break;
+			continue;
+		}
+
+		pos = console_ring_tail & (SBI_CONSOLE_ASYNC_SIZE - 1);
+		len = console_ring_head - console_ring_tail;
+		if (len > SBI_CONSOLE_ASYNC_SIZE - pos)
+			len = SBI_CONSOLE_ASYNC_SIZE - pos;
+		if (len > room)
+			len = room;
+		console_write(&console_ring[pos], len);
+		console_ring_tail += len;
+	}
+}
+
+static void console_ring_put(char ch)
+{
+	if (console_ring_head - console_ring_tail == SBI_CONSOLE_ASYNC_SIZE)
+		console_ring_drain(SBI_CONSOLE_ASYNC_SIZE - 1, TRUE);
+
+	console_ring[console_ring_head & (SBI_CONSOLE_ASYNC_SIZE - 1)] = ch;
+	console_ring_head++;
+}
+
+void sbi_console_drain(void)
+{
+	if (console_ring_head == console_ring_tail)
+		return;
+	if (!spin_trylock(&console_out_lock))
+		return;
+	if (console_ring_enabled())
+		console_ring_drain(0, FALSE);
+	spin_unlock(&console_out_lock);
+}
+
+void sbi_console_flush(void)
+{
+	spin_lock(&console_out_lock);
+	if (console_ring_enabled())
+		console_ring_drain(0, TRUE);
+	spin_unlock(&console_out_lock);
+}
+
+#else
+
+static bool console_ring_enabled(void)
+{
+	return FALSE;
+}
+
+#endif
+
+/* Must be called with console_out_lock held */
+static void console_putc(char ch)
+{
+	if (!console_dev)
+		return;
+
+#ifdef SBI_CONSOLE_ASYNC_SIZE
+	if (console_ring_enabled()) {
+		if (ch == '\n')
+			console_ring_put('\r');
+		console_ring_put(ch);
+		return;
+	}
+#endif
+
+	if (console_dev->console_putc) {
 		if (ch == '\n')
 			console_dev->console_putc('\r');
 		console_dev->console_putc(ch);
 	}
 }
 
-void sbi_puts(const char *str)
+void sbi_putc(char ch)
 {
 	spin_lock(&console_out_lock);
-	while (*str) {
-		sbi_putc(*str);
-		str++;
+	console_putc(ch);
+	spin_unlock(&console_out_lock);
+}
+
+static void nputs(const char *str, unsigned long len)
+{
+	unsigned long i, start = 0;
+
+	if (!console_dev || !console_dev->console_puts ||
+	    console_ring_enabled()) {
+		for (i = 0; i < len; i++)
+			console_putc(str[i]);
+		return;
 	}
+
+	/* Emit each line in one burst, with the '\r' console_putc() adds */
+	for (i = 0; i < len; i++) {
+		if (str[i] != '\n')
+			continue;
+		if (start < i)
+			console_write(&str[start], i - start);
+		console_write("\r\n", 2);
+		start = i + 1;
+	}
+	if (start < len)
+		console_write(&str[start], len - start);
+}
+
+void sbi_puts(const char *str)
+{
+	spin_lock(&console_out_lock);
+	nputs(str, sbi_strlen(str));
 	spin_unlock(&console_out_lock);
 }
 
+unsigned long sbi_nputs(const char *str, unsigned long len)
+{
+	spin_lock(&console_out_lock);
+	nputs(str, len);
+	spin_unlock(&console_out_lock);
+
+	return len;
+}
+
 void sbi_gets(char *s, int maxwidth, char endchar)
 {
 	int ch;
@@ -64,31 +212,51 @@ void sbi_gets(char *s, int maxwidth, char endchar)
 	*retval = '\0';
 }
 
+unsigned long sbi_ngets(char *str, unsigned long len)
+{
+	int ch;
+	unsigned long i;
+
+	for (i = 0; i < len; i++) {
+		ch = sbi_getc();
+		if (ch < 0)
+			break;
+		str[i] = ch;
+	}
+
+	return i;
+}
+
 #define PAD_RIGHT 1
 #define PAD_ZERO 2
 #define PAD_ALTERNATE 4
 #define PRINT_BUF_LEN 64
+#define CONSOLE_BUF_LEN 256
 
 #define va_start(v, l) __builtin_va_start((v), l)
 #define va_end __builtin_va_end
 #define va_arg __builtin_va_arg
+#define va_copy __builtin_va_copy
 typedef __builtin_va_list va_list;
 
+static const char digit_pairs[] =
+	"00010203040506070809" "10111213141516171819"
+	"20212223242526272829" "30313233343536373839"
+	"40414243444546474849" "50515253545556575859"
+	"60616263646566676869" "70717273747576777879"
+	"80818283848586878889" "90919293949596979899";
+
 static void printc(char **out, u32 *out_len, char ch)
 {
 	if (out) {
-		if (*out) {
-			if (out_len && (0 < *out_len)) {
-				**out = ch;
-				++(*out);
+		if (*out && (!out_len || *out_len)) {
+			**out = ch;
+			++(*out);
+			if (out_len)
 				(*out_len)--;
-			} else {
-				**out = ch;
-				++(*out);
-			}
 		}
 	} else {
-		sbi_putc(ch);
+		console_putc(ch);
 	}
 }
 
@@ -134,7 +302,7 @@ static int printi(char **out, u32 *out_len, long long i, int b, int sg,
 	char print_buf[PRINT_BUF_LEN];
 	char *s;
 	int neg = 0, pc = 0;
-	u64 t;
+	unsigned long t, v;
 	unsigned long long u = i;
 
 	if (sg && b == 10 && i < 0) {
@@ -145,15 +313,30 @@ static int printi(char **out, u32 *out_len, long long i, int b, int sg,
 	s  = print_buf + PRINT_BUF_LEN - 1;
 	*s = '\0';
 
-	if (!u) {
-		*--s = '0';
+	if (b == 16) {
+		do {
+			t = u & 0xf;
+			u >>= 4;
+			*--s = (t < 10) ? t + '0' : t - 10 + letbase;
+		} while (u);
 	} else {
-		while (u) {
-			t = u % b;
-			u = u / b;
-			if (t >= 10)
-				t += letbase - '0' - 10;
-			*--s = t + '0';
+		/* Two digits per division, in XLEN arithmetic when possible */
+		while (u > -1UL) {
+			t = u % 100;
+			u /= 100;
+			*--s = digit_pairs[2 * t + 1];
+			*--s = digit_pairs[2 * t];
+		}
+		for (v = u; v >= 100; v /= 100) {
+			t = v % 100;
+			*--s = digit_pairs[2 * t + 1];
+			*--s = digit_pairs[2 * t];
+		}
+		if (v >= 10) {
+			*--s = digit_pairs[2 * v + 1];
+			*--s = digit_pairs[2 * v];
+		} else {
+			*--s = v + '0';
 		}
 	}
 
@@ -360,6 +543,11 @@ int sbi_snprintf(char *out, u32 out_sz, const char *format, ...)
 	va_list args;
 	int retval;
 
+	if (!out_sz)
+		return 0;
+	/* Keep room for the terminating NUL */
+	out_sz--;
+
 	va_start(args, format);
 	retval = print(&out, &out_sz, format, args);
 	va_end(args);
@@ -367,16 +555,40 @@ int sbi_snprintf(char *out, u32 out_sz, const char *format, ...)
 	return retval;
 }
 
+/*
+ * Format into a buffer on the stack first and send the result to the
+ * console with one lock acquisition. Output which does not fit is
+ * formatted again straight to the console, still under the lock.
+ */
+static int console_vprintf(const char *format, va_list args)
+{
+	char buf[CONSOLE_BUF_LEN], *out = buf;
+	u32 out_len = sizeof(buf) - 1;
+	va_list args_copy;
+	int retval;
+
+	va_copy(args_copy, args);
+	retval = print(&out, &out_len, format, args_copy);
+	va_end(args_copy);
+
+	spin_lock(&console_out_lock);
+	if (retval < CONSOLE_BUF_LEN)
+		nputs(buf, retval);
+	else
+		retval = print(NULL, NULL, format, args);
+	spin_unlock(&console_out_lock);
+
+	return retval;
+}
+
 int sbi_printf(const char *format, ...)
 {
 	va_list args;
 	int retval;
 
-	spin_lock(&console_out_lock);
 	va_start(args, format);
-	retval = print(NULL, NULL, format, args);
+	retval = console_vprintf(format, args);
 	va_end(args);
-	spin_unlock(&console_out_lock);
 
 	return retval;
 }
@@ -388,11 +600,8 @@ int sbi_dprintf(const char *format, ...)
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
 	va_start(args, format);
-	if (scratch->options & SBI_SCRATCH_DEBUG_PRINTS) {
-		spin_lock(&console_out_lock);
-		retval = print(NULL, NULL, format, args);
-		spin_unlock(&console_out_lock);
-	}
+	if (scratch->options & SBI_SCRATCH_DEBUG_PRINTS)
+		retval = console_vprintf(format, args);
 	va_end(args);
 
 	return retval;
@@ -402,11 +611,9 @@ void sbi_panic(const char *format, ...)
 {
 	va_list args;
 
-	spin_lock(&console_out_lock);
 	va_start(args, format);
-	print(NULL, NULL, format, args);
+	console_vprintf(format, args);
 	va_end(args);
-	spin_unlock(&console_out_lock);
 
 	sbi_hart_hang();
 }
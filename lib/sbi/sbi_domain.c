@@ -140,6 +140,63 @@ bool sbi_domain_check_addr(const struct sbi_domain *dom,
 	return (mode == PRV_M) ? TRUE : FALSE;
 }
 
+/*
+ * Find the lowest memory region boundary in (addr, last], which is where
+ * the permissions of the following addresses may change. Return FALSE if
+ * there is none.
+ */
+static bool domain_next_boundary(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long last,
+				 unsigned long *next)
+{
+	struct sbi_domain_memregion *reg;
+	unsigned long rstart, rend;
+	bool found = FALSE;
+
+	sbi_domain_for_each_memregion(dom, reg) {
+		rstart = reg->base;
+		rend = (reg->order < __riscv_xlen) ?
+			rstart + ((1UL << reg->order) - 1) : -1UL;
+		if (addr < rstart && rstart <= last &&
+		    (!found || rstart < *next)) {
+			*next = rstart;
+			found = TRUE;
+		}
+		if (addr <= rend && rend < last &&
+		    (!found || rend + 1 < *next)) {
+			*next = rend + 1;
+			found = TRUE;
+		}
+	}
+
+	return found;
+}
+
+bool sbi_domain_check_addr_range(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long size,
+				 unsigned long mode,
+				 unsigned long access_flags)
+{
+	unsigned long last = addr + size - 1;
+
+	if (!dom)
+		return FALSE;
+	if (!size)
+		return TRUE;
+	if (last < addr)
+		return FALSE;
+
+	/* Permissions only change at region boundaries */
+	while (1) {
+		if (!sbi_domain_check_addr(dom, addr, mode, access_flags))
+			return FALSE;
+		if (!domain_next_boundary(dom, addr, last, &addr))
+			break;
+	}
+
+	return TRUE;
+}
+
 /* Check if region complies with constraints */
 static bool is_region_valid(const struct sbi_domain_memregion *reg)
 {
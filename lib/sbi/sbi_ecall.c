@@ -11,6 +11,7 @@
 #include <sbi/sbi_ecall.h>
 #include <sbi/sbi_ecall_interface.h>
 #include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
 #include <sbi/sbi_trap.h>
 
 u16 sbi_ecall_version_major(void)
@@ -37,17 +38,116 @@ void sbi_ecall_set_impid(unsigned long impid)
 
 static SBI_LIST_HEAD(ecall_exts_list);
 
+/*
+ * Extensions outside the experimental, vendor and firmware ranges are
+ * also kept in an array sorted by extid_start, which is searched before
+ * walking ecall_exts_list. Each HART remembers the last extension found
+ * together with the value of ecall_exts_gen at that time.
+ */
+#define SBI_ECALL_MAX_STD_EXTS		16
+
+static struct sbi_ecall_extension *ecall_std_exts[SBI_ECALL_MAX_STD_EXTS];
+static u32 ecall_std_exts_count;
+static unsigned long ecall_exts_gen;
+
+struct ecall_last_hit {
+	struct sbi_ecall_extension *ext;
+	unsigned long gen;
+};
+
+static unsigned long ecall_last_hit_off;
+
+static inline bool ecall_extid_is_std(unsigned long extid)
+{
+	return extid < SBI_EXT_EXPERIMENTAL_START ||
+	       SBI_EXT_FIRMWARE_END < extid;
+}
+
+static inline bool ecall_ext_is_std(struct sbi_ecall_extension *ext)
+{
+	return ext->extid_end < SBI_EXT_EXPERIMENTAL_START ||
+	       SBI_EXT_FIRMWARE_END < ext->extid_start;
+}
+
+static struct sbi_ecall_extension *ecall_find_std_extension(
+						unsigned long extid)
+{
+	struct sbi_ecall_extension *t;
+	u32 lo = 0, hi = ecall_std_exts_count, mid;
+
+	/* Find the last extension with extid_start <= extid */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (ecall_std_exts[mid]->extid_start <= extid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!lo)
+		return NULL;
+
+	t = ecall_std_exts[lo - 1];
+	return (extid <= t->extid_end) ? t : NULL;
+}
+
+static void ecall_std_exts_add(struct sbi_ecall_extension *ext)
+{
+	u32 i;
+
+	if (!ecall_ext_is_std(ext) ||
+	    ecall_std_exts_count == SBI_ECALL_MAX_STD_EXTS)
+		return;
+
+	for (i = ecall_std_exts_count; i > 0; i--) {
+		if (ecall_std_exts[i - 1]->extid_start < ext->extid_start)
+			break;
+		ecall_std_exts[i] = ecall_std_exts[i - 1];
+	}
+	ecall_std_exts[i] = ext;
+	ecall_std_exts_count++;
+}
+
+static void ecall_std_exts_del(struct sbi_ecall_extension *ext)
+{
+	u32 i, j;
+
+	for (i = j = 0; i < ecall_std_exts_count; i++) {
+		if (ecall_std_exts[i] != ext)
+			ecall_std_exts[j++] = ecall_std_exts[i];
+	}
+	ecall_std_exts_count = j;
+}
+
 struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid)
 {
 	struct sbi_ecall_extension *t, *ret = NULL;
+	struct ecall_last_hit *hit = NULL;
 
-	sbi_list_for_each_entry(t, &ecall_exts_list, head) {
-		if (t->extid_start <= extid && extid <= t->extid_end) {
-			ret = t;
-			break;
+	if (ecall_last_hit_off) {
+		hit = sbi_scratch_thishart_offset_ptr(ecall_last_hit_off);
+		t = hit->ext;
+		if (t && hit->gen == ecall_exts_gen &&
+		    t->extid_start <= extid && extid <= t->extid_end)
+			return t;
+	}
+
+	if (ecall_extid_is_std(extid))
+		ret = ecall_find_std_extension(extid);
+
+	if (!ret) {
+		sbi_list_for_each_entry(t, &ecall_exts_list, head) {
+			if (t->extid_start <= extid && extid <= t->extid_end) {
+				ret = t;
+				break;
+			}
 		}
 	}
 
+	if (ret && hit) {
+		hit->ext = ret;
+		hit->gen = ecall_exts_gen;
+	}
+
 	return ret;
 }
 
@@ -69,6 +169,8 @@ int sbi_ecall_register_extension(struct sbi_ecall_extension *ext)
 
 	SBI_INIT_LIST_HEAD(&ext->head);
 	sbi_list_add_tail(&ext->head, &ecall_exts_list);
+	ecall_std_exts_add(ext);
+	ecall_exts_gen++;
 
 	return 0;
 }
@@ -88,8 +190,11 @@ void sbi_ecall_unregister_extension(struct sbi_ecall_extension *ext)
 		}
 	}
 
-	if (found)
+	if (found) {
 		sbi_list_del_init(&ext->head);
+		ecall_std_exts_del(ext);
+		ecall_exts_gen++;
+	}
 }
 
 int sbi_ecall_handler(struct sbi_trap_regs *regs)
@@ -145,7 +250,11 @@ int sbi_ecall_init(void)
 {
 	int ret;
 
-	/* The order of below registrations is performance optimized */
+	ecall_last_hit_off = sbi_scratch_alloc_offset(
+					sizeof(struct ecall_last_hit));
+	if (!ecall_last_hit_off)
+		return SBI_ENOMEM;
+
 	ret = sbi_ecall_register_extension(&ecall_time);
 	if (ret)
 		return ret;
@@ -165,6 +274,12 @@ int sbi_ecall_init(void)
 	if (ret)
 		return ret;
 	ret = sbi_ecall_register_extension(&ecall_pmu);
+	if (ret)
+		return ret;
+	ret = sbi_ecall_register_extension(&ecall_dbcn);
+	if (ret)
+		return ret;
+	ret = sbi_ecall_register_extension(&ecall_fp_emul);
 	if (ret)
 		return ret;
 	ret = sbi_ecall_register_extension(&ecall_legacy);
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_trap.h>
+
+/*
+ * The buffer is given by its physical address, so OpenSBI accesses it
+ * directly once the calling domain is known to have access to it.
+ */
+static int dbcn_buffer_check(const struct sbi_trap_regs *regs,
+			     unsigned long len, unsigned long addr_lo,
+			     unsigned long addr_hi, unsigned long access)
+{
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+	ulong mode = (regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
+
+	if (addr_hi || addr_lo + len < addr_lo)
+		return SBI_EINVAL;
+	if (!sbi_domain_check_addr_range(dom, addr_lo, len, mode, access))
+		return SBI_EINVAL;
+
+	return 0;
+}
+
+static int sbi_ecall_dbcn_probe(unsigned long extid,
+				unsigned long *out_val)
+{
+	*out_val = sbi_console_get_device() ? 1 : 0;
+	return 0;
+}
+
+static int sbi_ecall_dbcn_handler(unsigned long extid, unsigned long funcid,
+				  const struct sbi_trap_regs *regs,
+				  unsigned long *out_val,
+				  struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_DBCN_CONSOLE_WRITE:
+		ret = dbcn_buffer_check(regs, regs->a0, regs->a1, regs->a2,
+					SBI_DOMAIN_READ);
+		if (!ret)
+			*out_val = sbi_nputs((const char *)regs->a1,
+					     regs->a0);
+		break;
+	case SBI_EXT_DBCN_CONSOLE_READ:
+		ret = dbcn_buffer_check(regs, regs->a0, regs->a1, regs->a2,
+					SBI_DOMAIN_WRITE);
+		if (!ret)
+			*out_val = sbi_ngets((char *)regs->a1, regs->a0);
+		break;
+	case SBI_EXT_DBCN_CONSOLE_WRITE_BYTE:
+		sbi_putc(regs->a0);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_dbcn = {
+	.extid_start = SBI_EXT_DBCN,
+	.extid_end = SBI_EXT_DBCN,
+	.probe = sbi_ecall_dbcn_probe,
+	.handle = sbi_ecall_dbcn_handler,
+};
@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_bitops.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_trap.h>
+
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+
+#include <sbi/sbi_fp_emulation.h>
+
+/*
+ * The state buffer has the layout of struct __riscv_d_ext_state of Linux
+ * (or of struct __riscv_q_ext_state with SBI_FP_EMUL_FLAG_Q): 32 registers
+ * of one (or two) 64-bit words each, followed by the 32-bit FCSR.
+ */
+static int fp_emul_state_ptr(const struct sbi_trap_regs *regs,
+			     unsigned long addr_lo, unsigned long addr_hi,
+			     unsigned long flags, unsigned long access,
+			     u64 **state, int *regs_per_f)
+{
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+	ulong mode = (regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
+	unsigned long size;
+
+	if (flags & ~SBI_FP_EMUL_FLAG_Q)
+		return SBI_EINVAL;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	*regs_per_f = (flags & SBI_FP_EMUL_FLAG_Q) ? 2 : 1;
+#else
+	if (flags & SBI_FP_EMUL_FLAG_Q)
+		return SBI_ENOTSUPP;
+	*regs_per_f = 1;
+#endif
+
+	/* The buffer is given by its physical address */
+	size = 32 * *regs_per_f * sizeof(u64) + sizeof(u32);
+	if (addr_hi || (addr_lo & (sizeof(u64) - 1)) ||
+	    addr_lo + size < addr_lo)
+		return SBI_EINVALID_ADDR;
+	if (!sbi_domain_check_addr_range(dom, addr_lo, size, mode, access))
+		return SBI_EINVALID_ADDR;
+
+	*state = (u64 *)addr_lo;
+	return 0;
+}
+
+static int fp_emul_save(const struct sbi_trap_regs *regs,
+			unsigned long addr_lo, unsigned long addr_hi,
+			unsigned long flags)
+{
+	int64_t *f = GET_FP_REGS(regs);
+	int i, rc, regs_per_f;
+	u64 *state;
+
+	rc = fp_emul_state_ptr(regs, addr_lo, addr_hi, flags,
+			       SBI_DOMAIN_WRITE, &state, &regs_per_f);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < 32; i++) {
+		state[i * regs_per_f] = f[i];
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+		if (regs_per_f == 2)
+			state[i * 2 + 1] = sbi_fp_qreg_hi()[i];
+#endif
+	}
+	*(u32 *)&state[32 * regs_per_f] = GET_FCSR();
+
+	return 0;
+}
+
+static int fp_emul_restore(const struct sbi_trap_regs *regs,
+			   unsigned long addr_lo, unsigned long addr_hi,
+			   unsigned long flags)
+{
+	int64_t *f = GET_FP_REGS(regs);
+	int i, rc, regs_per_f;
+	u64 *state;
+
+	rc = fp_emul_state_ptr(regs, addr_lo, addr_hi, flags,
+			       SBI_DOMAIN_READ, &state, &regs_per_f);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < 32; i++) {
+		f[i] = state[i * regs_per_f];
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+		if (regs_per_f == 2)
+			sbi_fp_qreg_hi()[i] = state[i * 2 + 1];
+#endif
+	}
+	/* The caller decides about FS, like after FLD/FSCSR with FS clean */
+	tp = *(u32 *)&state[32 * regs_per_f] & 0xFF;
+
+	return 0;
+}
+
+static int sbi_ecall_fp_emul_probe(unsigned long extid,
+				   unsigned long *out_val)
+{
+	*out_val = 1;
+	return 0;
+}
+
+static int sbi_ecall_fp_emul_handler(unsigned long extid,
+				     unsigned long funcid,
+				     const struct sbi_trap_regs *regs,
+				     unsigned long *out_val,
+				     struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_FP_EMUL_GET_FS:
+		*out_val = EXTRACT_FIELD(regs->mstatus, MSTATUS_FS);
+		break;
+	case SBI_EXT_FP_EMUL_SAVE:
+		ret = fp_emul_save(regs, regs->a0, regs->a1, regs->a2);
+		break;
+	case SBI_EXT_FP_EMUL_RESTORE:
+		ret = fp_emul_restore(regs, regs->a0, regs->a1, regs->a2);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+#else
+
+static int sbi_ecall_fp_emul_probe(unsigned long extid,
+				   unsigned long *out_val)
+{
+	*out_val = 0;
+	return 0;
+}
+
+static int sbi_ecall_fp_emul_handler(unsigned long extid,
+				     unsigned long funcid,
+				     const struct sbi_trap_regs *regs,
+				     unsigned long *out_val,
+				     struct sbi_trap_info *out_trap)
+{
+	return SBI_ENOTSUPP;
+}
+
+#endif
+
+struct sbi_ecall_extension ecall_fp_emul = {
+	.extid_start = SBI_EXT_FP_EMUL,
+	.extid_end = SBI_EXT_FP_EMUL,
+	.probe = sbi_ecall_fp_emul_probe,
+	.handle = sbi_ecall_fp_emul_handler,
+};
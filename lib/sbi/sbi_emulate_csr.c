@@ -204,13 +204,13 @@ int sbi_emulate_csr_write(int csr_num, struct sbi_trap_regs *regs,
 #endif
 #if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
     case CSR_FRM:
-	    SET_FRM(csr_val);
+	    SET_FRM(csr_val, regs);
 	    return 0;
     case CSR_FFLAGS:
-	    SET_FFLAGS(csr_val);
+	    SET_FFLAGS(csr_val, regs);
 	    return 0;
     case CSR_FCSR:
-	    SET_FCSR(csr_val);
+	    SET_FCSR(csr_val, regs);
 	    return 0;
 #endif
 	default:
@@ -13,6 +13,7 @@
 #include <sbi/sbi_emulate_csr.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_fp_emulation.h>
+#include <sbi/sbi_fp_kernels.h>
 #include <sbi/sbi_illegal_insn.h>
 #include <sbi/sbi_pmu.h>
 #include <sbi/sbi_trap.h>
@@ -27,59 +28,71 @@
 # error single-float only is not supported
 #endif
 
-int fp_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
+illegal_insn_func fp_opcode_decode(ulong insn)
 {
   asm (".pushsection .rodata\n"
        "fp_emulation_table:\n"
-       "  .word emulate_fadd - fp_emulation_table\n"
-       "  .word emulate_fsub - fp_emulation_table\n"
-       "  .word emulate_fmul - fp_emulation_table\n"
-       "  .word emulate_fdiv - fp_emulation_table\n"
-       "  .word emulate_fsgnj - fp_emulation_table\n"
-       "  .word emulate_fmin - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fcvt_ff - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fsqrt - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fcmp - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fcvt_if - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fcvt_fi - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fmv_if - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
-       "  .word emulate_fmv_fi - fp_emulation_table\n"
-       "  .word truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fadd - fp_emulation_table\n"
+       "  .4byte emulate_fsub - fp_emulation_table\n"
+       "  .4byte emulate_fmul - fp_emulation_table\n"
+       "  .4byte emulate_fdiv - fp_emulation_table\n"
+       "  .4byte emulate_fsgnj - fp_emulation_table\n"
+       "  .4byte emulate_fmin - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fcvt_ff - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fsqrt - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fcmp - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fcvt_if - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fcvt_fi - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fmv_if - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
+       "  .4byte emulate_fmv_fi - fp_emulation_table\n"
+       "  .4byte truly_illegal_insn - fp_emulation_table\n"
        "  .popsection");
 
+  extern uint32_t fp_emulation_table[];
+  int32_t* pf = (void*)fp_emulation_table + ((insn >> 25) & 0x7c);
+  return (illegal_insn_func)((void *)fp_emulation_table + *pf);
+}
+
+int fp_opcode_exec(illegal_insn_func f, ulong insn, struct sbi_trap_regs *regs)
+{
   int ret = 0;
+  ulong epc = regs->mepc;
   // if FPU is disabled, punt back to the OS
   if (unlikely((regs->mstatus & MSTATUS_FS) == 0))
     return truly_illegal_insn(insn, regs);
 
-  extern uint32_t fp_emulation_table[];
-  int32_t* pf = (void*)fp_emulation_table + ((insn >> 25) & 0x7c);
-  illegal_insn_func f = (illegal_insn_func)((void *)fp_emulation_table + *pf);
-
   SETUP_STATIC_ROUNDING(insn);
   ret = f(insn, regs);
-  regs->mepc += 4;
+  // a redirected trap has already updated mepc
+  if (regs->mepc == epc)
+    regs->mepc += 4;
   return ret;
 }
 
+int fp_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
+{
+  return fp_opcode_exec(fp_opcode_decode(insn), insn, regs);
+}
+
+#define f16(x) ((float16_t){ .v = x })
 #define f32(x) ((float32_t){ .v = x })
 #define f64(x) ((float64_t){ .v = x })
 
@@ -88,11 +101,23 @@ int emulate_any_fadd(ulong insn, struct sbi_trap_regs *regs, int32_t neg_b)
   if (GET_PRECISION(insn) == PRECISION_S) {
     uint32_t rs1 = GET_F32_RS1(insn, regs);
     uint32_t rs2 = GET_F32_RS2(insn, regs) ^ neg_b;
-    SET_F32_RD(insn, regs, f32_add(f32(rs1), f32(rs2)).v);
+    SET_F32_RD(insn, regs, fp_fast_f32_add(f32(rs1), f32(rs2)).v);
   } else if (GET_PRECISION(insn) == PRECISION_D) {
     uint64_t rs1 = GET_F64_RS1(insn, regs);
     uint64_t rs2 = GET_F64_RS2(insn, regs) ^ ((uint64_t)neg_b << 32);
-    SET_F64_RD(insn, regs, f64_add(f64(rs1), f64(rs2)).v);
+    SET_F64_RD(insn, regs, fp_fast_f64_add(f64(rs1), f64(rs2)).v);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs);
+    uint16_t rs2 = GET_F16_RS2(insn, regs) ^ ((uint32_t)neg_b >> 16);
+    SET_F16_RD(insn, regs, f16_add(f16(rs1), f16(rs2)).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs), rd;
+    rs2.v[1] ^= (uint64_t)neg_b << 32;
+    f128M_add(&rs1, &rs2, &rd);
+    SET_F128_RD(insn, regs, rd);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -115,11 +140,22 @@ int emulate_fmul(ulong insn, struct sbi_trap_regs *regs)
   if (GET_PRECISION(insn) == PRECISION_S) {
     uint32_t rs1 = GET_F32_RS1(insn, regs);
     uint32_t rs2 = GET_F32_RS2(insn, regs);
-    SET_F32_RD(insn, regs, f32_mul(f32(rs1), f32(rs2)).v);
+    SET_F32_RD(insn, regs, fp_fast_f32_mul(f32(rs1), f32(rs2)).v);
   } else if (GET_PRECISION(insn) == PRECISION_D) {
     uint64_t rs1 = GET_F64_RS1(insn, regs);
     uint64_t rs2 = GET_F64_RS2(insn, regs);
-    SET_F64_RD(insn, regs, f64_mul(f64(rs1), f64(rs2)).v);
+    SET_F64_RD(insn, regs, fp_fast_f64_mul(f64(rs1), f64(rs2)).v);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs);
+    uint16_t rs2 = GET_F16_RS2(insn, regs);
+    SET_F16_RD(insn, regs, f16_mul(f16(rs1), f16(rs2)).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs), rd;
+    f128M_mul(&rs1, &rs2, &rd);
+    SET_F128_RD(insn, regs, rd);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -132,11 +168,22 @@ int emulate_fdiv(ulong insn, struct sbi_trap_regs *regs)
   if (GET_PRECISION(insn) == PRECISION_S) {
     uint32_t rs1 = GET_F32_RS1(insn, regs);
     uint32_t rs2 = GET_F32_RS2(insn, regs);
-    SET_F32_RD(insn, regs, f32_div(f32(rs1), f32(rs2)).v);
+    SET_F32_RD(insn, regs, fp_fast_f32_div(f32(rs1), f32(rs2)).v);
   } else if (GET_PRECISION(insn) == PRECISION_D) {
     uint64_t rs1 = GET_F64_RS1(insn, regs);
     uint64_t rs2 = GET_F64_RS2(insn, regs);
-    SET_F64_RD(insn, regs, f64_div(f64(rs1), f64(rs2)).v);
+    SET_F64_RD(insn, regs, fp_fast_f64_div(f64(rs1), f64(rs2)).v);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs);
+    uint16_t rs2 = GET_F16_RS2(insn, regs);
+    SET_F16_RD(insn, regs, f16_div(f16(rs1), f16(rs2)).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs), rd;
+    f128M_div(&rs1, &rs2, &rd);
+    SET_F128_RD(insn, regs, rd);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -150,9 +197,17 @@ int emulate_fsqrt(ulong insn, struct sbi_trap_regs *regs)
 	  return truly_illegal_insn(insn, regs);
 
   if (GET_PRECISION(insn) == PRECISION_S) {
-    SET_F32_RD(insn, regs, f32_sqrt(f32(GET_F32_RS1(insn, regs))).v);
+    SET_F32_RD(insn, regs, fp_fast_f32_sqrt(f32(GET_F32_RS1(insn, regs))).v);
   } else if (GET_PRECISION(insn) == PRECISION_D) {
-    SET_F64_RD(insn, regs, f64_sqrt(f64(GET_F64_RS1(insn, regs))).v);
+    SET_F64_RD(insn, regs, fp_fast_f64_sqrt(f64(GET_F64_RS1(insn, regs))).v);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    SET_F16_RD(insn, regs, f16_sqrt(f16(GET_F16_RS1(insn, regs))).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs), rd;
+    f128M_sqrt(&rs1, &rd);
+    SET_F128_RD(insn, regs, rd);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -181,6 +236,17 @@ int emulate_fsgnj(ulong insn, struct sbi_trap_regs *regs)
     uint64_t rs1 = GET_F64_RS1(insn, regs);
     uint64_t rs2 = GET_F64_RS2(insn, regs);
     SET_F64_RD(insn, regs, DO_FSGNJ(rs1, rs2, rm));
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint32_t rs1 = (uint32_t)GET_F16_RS1(insn, regs) << 16;
+    uint32_t rs2 = (uint32_t)GET_F16_RS2(insn, regs) << 16;
+    SET_F16_RD(insn, regs, DO_FSGNJ(rs1, rs2, rm) >> 16);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    uint64_t rs2_hi = GET_FQ_HI(insn, 20);
+    rs1.v[1] = DO_FSGNJ(rs1.v[1], rs2_hi, rm);
+    SET_F128_RD(insn, regs, rs1);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -208,6 +274,21 @@ int emulate_fmin(ulong insn, struct sbi_trap_regs *regs)
     uint64_t arg2 = rm ? rs1 : rs2;
     int use_rs1 = f64_lt_quiet(f64(arg1), f64(arg2)) || isNaNF64UI(rs2);
     SET_F64_RD(insn, regs, use_rs1 ? rs1 : rs2);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs);
+    uint16_t rs2 = GET_F16_RS2(insn, regs);
+    uint16_t arg1 = rm ? rs2 : rs1;
+    uint16_t arg2 = rm ? rs1 : rs2;
+    int use_rs1 = f16_lt_quiet(f16(arg1), f16(arg2)) || isNaNF16UI(rs2);
+    SET_F16_RD(insn, regs, use_rs1 ? rs1 : rs2);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs);
+    int use_rs1 = (rm ? f128M_lt_quiet(&rs2, &rs1) : f128M_lt_quiet(&rs1, &rs2)) ||
+                  softfloat_isNaNF128M((const uint32_t *)&rs2);
+    SET_F128_RD(insn, regs, use_rs1 ? rs1 : rs2);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
@@ -218,16 +299,58 @@ int emulate_fmin(ulong insn, struct sbi_trap_regs *regs)
 int emulate_fcvt_ff(ulong insn, struct sbi_trap_regs *regs)
 {
   int rs2_num = (insn >> 20) & 0x1f;
-  if (GET_PRECISION(insn) == PRECISION_S) {
-    if (rs2_num != 1)
-      return truly_illegal_insn(insn, regs);
-    SET_F32_RD(insn, regs, f64_to_f32(f64(GET_F64_RS1(insn, regs))).v);
-  } else if (GET_PRECISION(insn) == PRECISION_D) {
-    if (rs2_num != 0)
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  float128_t rs1, rd;
+#endif
+
+  // the rs2 field holds the precision of the source operand
+  switch (GET_PRECISION(insn) << 2 | rs2_num) {
+    case PRECISION_S << 2 | PRECISION_D:
+      SET_F32_RD(insn, regs, f64_to_f32(f64(GET_F64_RS1(insn, regs))).v);
+      break;
+    case PRECISION_S << 2 | PRECISION_H:
+      SET_F32_RD(insn, regs, f16_to_f32(f16(GET_F16_RS1(insn, regs))).v);
+      break;
+    case PRECISION_D << 2 | PRECISION_S:
+      SET_F64_RD(insn, regs, f32_to_f64(f32(GET_F32_RS1(insn, regs))).v);
+      break;
+    case PRECISION_D << 2 | PRECISION_H:
+      SET_F64_RD(insn, regs, f16_to_f64(f16(GET_F16_RS1(insn, regs))).v);
+      break;
+    case PRECISION_H << 2 | PRECISION_S:
+      SET_F16_RD(insn, regs, f32_to_f16(f32(GET_F32_RS1(insn, regs))).v);
+      break;
+    case PRECISION_H << 2 | PRECISION_D:
+      SET_F16_RD(insn, regs, f64_to_f16(f64(GET_F64_RS1(insn, regs))).v);
+      break;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+    case PRECISION_S << 2 | PRECISION_Q:
+      rs1 = GET_F128_RS1(insn, regs);
+      SET_F32_RD(insn, regs, f128M_to_f32(&rs1).v);
+      break;
+    case PRECISION_D << 2 | PRECISION_Q:
+      rs1 = GET_F128_RS1(insn, regs);
+      SET_F64_RD(insn, regs, f128M_to_f64(&rs1).v);
+      break;
+    case PRECISION_H << 2 | PRECISION_Q:
+      rs1 = GET_F128_RS1(insn, regs);
+      SET_F16_RD(insn, regs, f128M_to_f16(&rs1).v);
+      break;
+    case PRECISION_Q << 2 | PRECISION_S:
+      f32_to_f128M(f32(GET_F32_RS1(insn, regs)), &rd);
+      SET_F128_RD(insn, regs, rd);
+      break;
+    case PRECISION_Q << 2 | PRECISION_D:
+      f64_to_f128M(f64(GET_F64_RS1(insn, regs)), &rd);
+      SET_F128_RD(insn, regs, rd);
+      break;
+    case PRECISION_Q << 2 | PRECISION_H:
+      f16_to_f128M(f16(GET_F16_RS1(insn, regs)), &rd);
+      SET_F128_RD(insn, regs, rd);
+      break;
+#endif
+    default:
       return truly_illegal_insn(insn, regs);
-    SET_F64_RD(insn, regs, f32_to_f64(f32(GET_F32_RS1(insn, regs))).v);
-  } else {
-    return truly_illegal_insn(insn, regs);
   }
 
   return 0;
@@ -235,7 +358,26 @@ int emulate_fcvt_ff(ulong insn, struct sbi_trap_regs *regs)
 
 int emulate_fcvt_fi(ulong insn, struct sbi_trap_regs *regs)
 {
-  if (GET_PRECISION(insn) != PRECISION_S && GET_PRECISION(insn) != PRECISION_D)
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rd;
+    switch ((insn >> 20) & 0x1f)
+    {
+      case 0: i32_to_f128M(GET_RS1(insn, regs), &rd); break;
+      case 1: ui32_to_f128M(GET_RS1(insn, regs), &rd); break;
+#if __riscv_xlen == 64
+      case 2: i64_to_f128M(GET_RS1(insn, regs), &rd); break;
+      case 3: ui64_to_f128M(GET_RS1(insn, regs), &rd); break;
+#endif
+      default: return truly_illegal_insn(insn, regs);
+    }
+    SET_F128_RD(insn, regs, rd);
+    return 0;
+  }
+
+#endif
+  if (GET_PRECISION(insn) != PRECISION_S && GET_PRECISION(insn) != PRECISION_D &&
+      GET_PRECISION(insn) != PRECISION_H)
     return truly_illegal_insn(insn, regs);
 
   int negative = 0;
@@ -267,6 +409,8 @@ int emulate_fcvt_fi(ulong insn, struct sbi_trap_regs *regs)
 
   if (GET_PRECISION(insn) == PRECISION_S)
     SET_F32_RD(insn, regs, f64_to_f32(f64(float64)).v);
+  else if (GET_PRECISION(insn) == PRECISION_H)
+    SET_F16_RD(insn, regs, f64_to_f16(f64(float64)).v);
   else
 	  SET_F64_RD(insn, regs, float64);
 
@@ -284,70 +428,51 @@ int emulate_fcvt_if(ulong insn, struct sbi_trap_regs *regs)
     return truly_illegal_insn(insn, regs);
 #endif
 
-  int64_t float64;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    int rm = softfloat_roundingMode;
+    uint64_t result;
+    switch (rs2_num)
+    {
+      case 0: result = (int32_t)f128M_to_i32(&rs1, rm, true); break;
+      case 1: result = (int32_t)f128M_to_ui32(&rs1, rm, true); break;
+      case 2: result = f128M_to_i64(&rs1, rm, true); break;
+      default: result = f128M_to_ui64(&rs1, rm, true); break;
+    }
+    SET_FS_DIRTY(regs);
+    SET_RD(insn, regs, result);
+    return 0;
+  }
+#endif
+
+  // H and S widen to D exactly, so rounding to an integer happens once
+  float64_t float64;
   if (GET_PRECISION(insn) == PRECISION_S)
-    float64 = f32_to_f64(f32(GET_F32_RS1(insn, regs))).v;
+    float64 = f32_to_f64(f32(GET_F32_RS1(insn, regs)));
   else if (GET_PRECISION(insn) == PRECISION_D)
-    float64 = GET_F64_RS1(insn, regs);
+    float64 = f64(GET_F64_RS1(insn, regs));
+  else if (GET_PRECISION(insn) == PRECISION_H)
+    float64 = f16_to_f64(f16(GET_F16_RS1(insn, regs)));
   else
     return truly_illegal_insn(insn, regs);
 
-  int negative = 0;
-  if (float64 < 0) {
-    negative = 1;
-    float64 ^= INT64_MIN;
-  }
-  uint64_t uint_val = f64_to_ui64(f64(float64), softfloat_roundingMode, true);
-  uint64_t result, limit, limit_result;
-
+  int rm = softfloat_roundingMode;
+  uint64_t result;
   switch (rs2_num)
   {
-    case 0: // int32
-      if (negative) {
-        result = (int32_t)-uint_val;
-        limit_result = limit = (uint32_t)INT32_MIN;
-      } else {
-        result = (int32_t)uint_val;
-        limit_result = limit = INT32_MAX;
-      }
-      break;
-
-    case 1: // uint32
-      limit = limit_result = UINT32_MAX;
-      if (negative)
-        result = limit = 0;
-      else
-        result = (uint32_t)uint_val;
-      break;
-
-    case 2: // int32
-      if (negative) {
-        result = (int64_t)-uint_val;
-        limit_result = limit = (uint64_t)INT64_MIN;
-      } else {
-        result = (int64_t)uint_val;
-        limit_result = limit = INT64_MAX;
-      }
-      break;
-
-    case 3: // uint64
-      limit = limit_result = UINT64_MAX;
-      if (negative)
-        result = limit = 0;
-      else
-        result = (uint64_t)uint_val;
-      break;
-
-    default:
-      __builtin_unreachable();
-  }
-
-  if (uint_val > limit) {
-    result = limit_result;
-    softfloat_raiseFlags(softfloat_flag_invalid);
+    // 32-bit results are sign-extended, also for the unsigned conversion
+    case 0: result = (int32_t)f64_to_i32(float64, rm, true); break;
+    case 1: result = (int32_t)f64_to_ui32(float64, rm, true); break;
+#if __riscv_xlen == 64
+    case 2: result = f64_to_i64(float64, rm, true); break;
+    default: result = f64_to_ui64(float64, rm, true); break;
+#else
+    default: __builtin_unreachable();
+#endif
   }
 
-  SET_FS_DIRTY();
+  SET_FS_DIRTY(regs);
   SET_RD(insn, regs, result);
 
   return 0;
@@ -376,10 +501,28 @@ int emulate_fcmp(ulong insn, struct sbi_trap_regs *regs)
     if (rm == 1 || (rm == 0 && !result))
       result = f64_lt(f64(rs1), f64(rs2));
     goto success;
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs);
+    uint16_t rs2 = GET_F16_RS2(insn, regs);
+    if (rm != 1)
+      result = f16_eq(f16(rs1), f16(rs2));
+    if (rm == 1 || (rm == 0 && !result))
+      result = f16_lt(f16(rs1), f16(rs2));
+    goto success;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs);
+    if (rm != 1)
+      result = f128M_eq(&rs1, &rs2);
+    if (rm == 1 || (rm == 0 && !result))
+      result = f128M_lt(&rs1, &rs2);
+    goto success;
+#endif
   }
   return truly_illegal_insn(insn, regs);
 success:
-  SET_FS_DIRTY();
+  SET_FS_DIRTY(regs);
   SET_RD(insn, regs, result);
 
   return 0;
@@ -405,11 +548,26 @@ int emulate_fmv_if(ulong insn, struct sbi_trap_regs *regs)
       case GET_RM(MATCH_FCLASS_D): result = f64_classify(f64(result)); break;
       default: return truly_illegal_insn(insn, regs);
     }
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    switch (GET_RM(insn)) {
+      // FMV.X.H moves the raw bits, only FCLASS.H checks the NaN-boxing
+      case GET_RM(MATCH_FMV_X_H): result = (int16_t)GET_F32_RS1(insn, regs); break;
+      case GET_RM(MATCH_FCLASS_H): result = f16_classify(f16(GET_F16_RS1(insn, regs))); break;
+      default: return truly_illegal_insn(insn, regs);
+    }
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    // there is no FMV.X.Q, only FCLASS.Q
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    if (GET_RM(insn) != GET_RM(MATCH_FCLASS_S))
+      return truly_illegal_insn(insn, regs);
+    result = f128M_classify(&rs1);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
 
-  SET_FS_DIRTY();
+  SET_FS_DIRTY(regs);
   SET_RD(insn, regs, result);
 
   return 0;
@@ -425,6 +583,8 @@ int emulate_fmv_fi(ulong insn, struct sbi_trap_regs *regs)
   else if ((insn & MASK_FMV_D_X) == MATCH_FMV_D_X)
     SET_F64_RD(insn, regs, rs1);
 #endif
+  else if ((insn & MASK_FMV_H_X) == MATCH_FMV_H_X)
+    SET_F16_RD(insn, regs, rs1);
   else
 	  return truly_illegal_insn(insn, regs);
 
@@ -450,6 +610,21 @@ int emulate_fmadd(ulong insn, struct sbi_trap_regs *regs)
     uint64_t rs2 = GET_F64_RS2(insn, regs);
     uint64_t rs3 = GET_F64_RS3(insn, regs) ^ (negC ? INT64_MIN : 0);
     SET_F64_RD(insn, regs, softfloat_mulAddF64(rs1, rs2, rs3, 0).v);
+  } else if (GET_PRECISION(insn) == PRECISION_H) {
+    uint16_t rs1 = GET_F16_RS1(insn, regs) ^ (negA ? 0x8000 : 0);
+    uint16_t rs2 = GET_F16_RS2(insn, regs);
+    uint16_t rs3 = GET_F16_RS3(insn, regs) ^ (negC ? 0x8000 : 0);
+    SET_F16_RD(insn, regs, softfloat_mulAddF16(rs1, rs2, rs3, 0).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+  } else if (GET_PRECISION(insn) == PRECISION_Q) {
+    float128_t rs1 = GET_F128_RS1(insn, regs);
+    float128_t rs2 = GET_F128_RS2(insn, regs);
+    float128_t rs3 = GET_F128_RS3(insn, regs), rd;
+    rs1.v[1] ^= negA ? INT64_MIN : 0;
+    rs3.v[1] ^= negC ? INT64_MIN : 0;
+    f128M_mulAdd(&rs1, &rs2, &rs3, &rd);
+    SET_F128_RD(insn, regs, rd);
+#endif
   } else {
     return truly_illegal_insn(insn, regs);
   }
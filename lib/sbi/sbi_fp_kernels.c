@@ -0,0 +1,636 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/sbi_fp_kernels.h>
+#include <sbi_utils/softfloat/internals.h>
+#include <sbi_utils/softfloat/softfloat.h>
+
+#ifdef SBI_ENABLE_FP_EMULATION
+
+/*
+ * The fast kernels only accept operands with a biased exponent in
+ * [1, EXP_MAX - 1] and results which are still normal after rounding.
+ * Tininess is detected after rounding, so a normal result never raises
+ * underflow and the only possible flag is inexact.
+ */
+#define F32_IS_NORMAL(exp)	((uint_fast16_t)((exp) - 1) < 0xFE)
+#define F64_IS_NORMAL(exp)	((uint_fast16_t)((exp) - 1) < 0x7FE)
+
+float32_t fp_fast_f32_add(float32_t a, float32_t b)
+{
+	uint32_t uiA = a.v, uiB = b.v, sig, sigA, sigB, roundBits, tmp;
+	int_fast16_t expA, expB, exp;
+	float32_t z;
+	bool sign;
+
+	/* Order operands by magnitude so that |A| >= |B| */
+	if ((uiA & 0x7FFFFFFF) < (uiB & 0x7FFFFFFF)) {
+		tmp = uiA;
+		uiA = uiB;
+		uiB = tmp;
+	}
+
+	expA = expF32UI(uiA);
+	expB = expF32UI(uiB);
+	if (unlikely(softfloat_roundingMode != softfloat_round_near_even ||
+		     !F32_IS_NORMAL(expA) || !F32_IS_NORMAL(expB)))
+		return f32_add(a, b);
+
+	/* Hidden bit at bit 29, six round bits below the LSB */
+	sign = signF32UI(uiA);
+	exp = expA;
+	sigA = (fracF32UI(uiA) | 0x00800000) << 6;
+	sigB = (fracF32UI(uiB) | 0x00800000) << 6;
+	if (expA != expB)
+		sigB = softfloat_shiftRightJam32(sigB, expA - expB);
+
+	if (signF32UI(uiA) == signF32UI(uiB)) {
+		sig = sigA + sigB;
+		if (sig & 0x40000000) {
+			sig = (sig >> 1) | (sig & 1);
+			exp++;
+		}
+	} else {
+		sig = sigA - sigB;
+		if (!sig) {
+			z.v = 0;
+			return z;
+		}
+		tmp = softfloat_countLeadingZeros32(sig) - 2;
+		sig <<= tmp;
+		exp -= tmp;
+		if (unlikely(exp < 1))
+			return f32_add(a, b);
+	}
+
+	roundBits = sig & 0x3F;
+	sig = (sig + 0x20) >> 6;
+	if (roundBits == 0x20)
+		sig &= ~(uint32_t)1;
+	if (unlikely(exp + (sig >> 24) >= 0xFF))
+		return f32_add(a, b);
+
+	if (roundBits)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF32UI(sign, exp - 1, sig);
+	return z;
+}
+
+float32_t fp_fast_f32_mul(float32_t a, float32_t b)
+{
+	uint32_t uiA = a.v, uiB = b.v, sig, rest;
+	int_fast16_t expA = expF32UI(uiA), expB = expF32UI(uiB), exp;
+	uint64_t prod;
+	float32_t z;
+
+	if (unlikely(softfloat_roundingMode != softfloat_round_near_even ||
+		     !F32_IS_NORMAL(expA) || !F32_IS_NORMAL(expB)))
+		return f32_mul(a, b);
+
+	/* 24x24-bit product in [2^46, 2^48), normalized to bit 47 */
+	exp = expA + expB - 0x7F;
+	prod = (uint64_t)(fracF32UI(uiA) | 0x00800000) *
+	       (fracF32UI(uiB) | 0x00800000);
+	if (prod & ((uint64_t)1 << 47))
+		exp++;
+	else
+		prod <<= 1;
+	if (unlikely(exp < 1))
+		return f32_mul(a, b);
+
+	sig = prod >> 24;
+	rest = prod & 0xFFFFFF;
+	if (rest > 0x800000 || (rest == 0x800000 && (sig & 1)))
+		sig++;
+	if (unlikely(exp + (sig >> 24) >= 0xFF))
+		return f32_mul(a, b);
+
+	if (rest)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF32UI(signF32UI(uiA) ^ signF32UI(uiB), exp - 1, sig);
+	return z;
+}
+
+float64_t fp_fast_f64_add(float64_t a, float64_t b)
+{
+	uint64_t uiA = a.v, uiB = b.v, sig, sigA, sigB, roundBits, tmp;
+	int_fast16_t expA, expB, exp;
+	float64_t z;
+	bool sign;
+
+	/* Order operands by magnitude so that |A| >= |B| */
+	if ((uiA & INT64_MAX) < (uiB & INT64_MAX)) {
+		tmp = uiA;
+		uiA = uiB;
+		uiB = tmp;
+	}
+
+	expA = expF64UI(uiA);
+	expB = expF64UI(uiB);
+	if (unlikely(softfloat_roundingMode != softfloat_round_near_even ||
+		     !F64_IS_NORMAL(expA) || !F64_IS_NORMAL(expB)))
+		return f64_add(a, b);
+
+	/* Hidden bit at bit 61, nine round bits below the LSB */
+	sign = signF64UI(uiA);
+	exp = expA;
+	sigA = (fracF64UI(uiA) | UINT64_C(0x0010000000000000)) << 9;
+	sigB = (fracF64UI(uiB) | UINT64_C(0x0010000000000000)) << 9;
+	if (expA != expB)
+		sigB = softfloat_shiftRightJam64(sigB, expA - expB);
+
+	if (signF64UI(uiA) == signF64UI(uiB)) {
+		sig = sigA + sigB;
+		if (sig & UINT64_C(0x4000000000000000)) {
+			sig = (sig >> 1) | (sig & 1);
+			exp++;
+		}
+	} else {
+		sig = sigA - sigB;
+		if (!sig) {
+			z.v = 0;
+			return z;
+		}
+		tmp = softfloat_countLeadingZeros64(sig) - 2;
+		sig <<= tmp;
+		exp -= tmp;
+		if (unlikely(exp < 1))
+			return f64_add(a, b);
+	}
+
+	roundBits = sig & 0x1FF;
+	sig = (sig + 0x100) >> 9;
+	if (roundBits == 0x100)
+		sig &= ~(uint64_t)1;
+	if (unlikely(exp + (sig >> 53) >= 0x7FF))
+		return f64_add(a, b);
+
+	if (roundBits)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF64UI(sign, exp - 1, sig);
+	return z;
+}
+
+float64_t fp_fast_f64_mul(float64_t a, float64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	uint64_t uiA = a.v, uiB = b.v, sig, rest;
+	int_fast16_t expA = expF64UI(uiA), expB = expF64UI(uiB), exp;
+	unsigned __int128 prod;
+	float64_t z;
+
+	if (unlikely(softfloat_roundingMode != softfloat_round_near_even ||
+		     !F64_IS_NORMAL(expA) || !F64_IS_NORMAL(expB)))
+		return f64_mul(a, b);
+
+	/* 53x53-bit product in [2^104, 2^106), normalized to bit 105 */
+	exp = expA + expB - 0x3FF;
+	prod = (unsigned __int128)(fracF64UI(uiA) |
+				   UINT64_C(0x0010000000000000)) *
+	       (fracF64UI(uiB) | UINT64_C(0x0010000000000000));
+	if ((uint64_t)(prod >> 105))
+		exp++;
+	else
+		prod <<= 1;
+	if (unlikely(exp < 1))
+		return f64_mul(a, b);
+
+	sig = prod >> 53;
+	rest = (uint64_t)prod & UINT64_C(0x001FFFFFFFFFFFFF);
+	if (rest > UINT64_C(0x0010000000000000) ||
+	    (rest == UINT64_C(0x0010000000000000) && (sig & 1)))
+		sig++;
+	if (unlikely(exp + (sig >> 53) >= 0x7FF))
+		return f64_mul(a, b);
+
+	if (rest)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF64UI(signF64UI(uiA) ^ signF64UI(uiB), exp - 1, sig);
+	return z;
+#else
+	return f64_mul(a, b);
+#endif
+}
+
+/*
+ * Seed tables for the division and square root kernels. fp_recip_seed[i]
+ * is 2^16 / B rounded, for B in the middle of [1 + i/256, 1 + (i+1)/256).
+ * fp_rsqrt_seed[i] is 2^16 / sqrt(X) rounded, for X in the middle of
+ * [1 + i/128, 1 + (i+1)/128) when i < 128 and of twice that interval
+ * otherwise. Both give about 8 correct bits.
+ */
+static const uint16_t fp_recip_seed[256] = {
+	0xFF80, 0xFE82, 0xFD86, 0xFC8C, 0xFB94, 0xFA9E, 0xF9A9, 0xF8B7,
+	0xF7C6, 0xF6D7, 0xF5EA, 0xF4FF, 0xF415, 0xF32D, 0xF247, 0xF163,
+	0xF080, 0xEF9F, 0xEEBF, 0xEDE1, 0xED05, 0xEC2A, 0xEB51, 0xEA7A,
+	0xE9A4, 0xE8CF, 0xE7FC, 0xE72B, 0xE65B, 0xE58C, 0xE4BF, 0xE3F4,
+	0xE329, 0xE260, 0xE199, 0xE0D3, 0xE00E, 0xDF4B, 0xDE88, 0xDDC8,
+	0xDD08, 0xDC4A, 0xDB8D, 0xDAD1, 0xDA17, 0xD95E, 0xD8A6, 0xD7EF,
+	0xD73A, 0xD685, 0xD5D2, 0xD520, 0xD46F, 0xD3BF, 0xD311, 0xD263,
+	0xD1B7, 0xD10C, 0xD062, 0xCFB9, 0xCF11, 0xCE6A, 0xCDC4, 0xCD1F,
+	0xCC7B, 0xCBD8, 0xCB36, 0xCA96, 0xC9F6, 0xC957, 0xC8B9, 0xC81C,
+	0xC780, 0xC6E5, 0xC64B, 0xC5B2, 0xC51A, 0xC482, 0xC3EC, 0xC357,
+	0xC2C2, 0xC22E, 0xC19B, 0xC109, 0xC078, 0xBFE8, 0xBF59, 0xBECA,
+	0xBE3C, 0xBDAF, 0xBD23, 0xBC98, 0xBC0D, 0xBB83, 0xBAFB, 0xBA72,
+	0xB9EB, 0xB964, 0xB8DE, 0xB859, 0xB7D5, 0xB751, 0xB6CE, 0xB64C,
+	0xB5CB, 0xB54A, 0xB4CA, 0xB44B, 0xB3CC, 0xB34E, 0xB2D1, 0xB254,
+	0xB1D8, 0xB15D, 0xB0E3, 0xB069, 0xAFF0, 0xAF77, 0xAEFF, 0xAE88,
+	0xAE11, 0xAD9B, 0xAD26, 0xACB1, 0xAC3D, 0xABC9, 0xAB56, 0xAAE4,
+	0xAA72, 0xAA01, 0xA990, 0xA920, 0xA8B1, 0xA842, 0xA7D3, 0xA766,
+	0xA6F8, 0xA68C, 0xA620, 0xA5B4, 0xA549, 0xA4DF, 0xA475, 0xA40C,
+	0xA3A3, 0xA33A, 0xA2D3, 0xA26B, 0xA204, 0xA19E, 0xA138, 0xA0D3,
+	0xA06E, 0xA00A, 0x9FA6, 0x9F43, 0x9EE0, 0x9E7E, 0x9E1C, 0x9DBA,
+	0x9D59, 0x9CF9, 0x9C99, 0x9C39, 0x9BDA, 0x9B7C, 0x9B1D, 0x9AC0,
+	0x9A62, 0x9A05, 0x99A9, 0x994D, 0x98F1, 0x9896, 0x983B, 0x97E1,
+	0x9787, 0x972E, 0x96D5, 0x967C, 0x9624, 0x95CC, 0x9574, 0x951D,
+	0x94C7, 0x9470, 0x941B, 0x93C5, 0x9370, 0x931B, 0x92C7, 0x9273,
+	0x921F, 0x91CC, 0x9179, 0x9127, 0x90D5, 0x9083, 0x9032, 0x8FE1,
+	0x8F90, 0x8F40, 0x8EF0, 0x8EA0, 0x8E51, 0x8E02, 0x8DB3, 0x8D65,
+	0x8D17, 0x8CC9, 0x8C7C, 0x8C2F, 0x8BE2, 0x8B96, 0x8B4A, 0x8AFF,
+	0x8AB3, 0x8A68, 0x8A1E, 0x89D3, 0x8989, 0x8940, 0x88F6, 0x88AD,
+	0x8864, 0x881C, 0x87D3, 0x878C, 0x8744, 0x86FD, 0x86B6, 0x866F,
+	0x8628, 0x85E2, 0x859C, 0x8557, 0x8511, 0x84CC, 0x8488, 0x8443,
+	0x83FF, 0x83BB, 0x8377, 0x8334, 0x82F1, 0x82AE, 0x826B, 0x8229,
+	0x81E7, 0x81A5, 0x8164, 0x8123, 0x80E2, 0x80A1, 0x8060, 0x8020,
+};
+
+static const uint16_t fp_rsqrt_seed[256] = {
+	0xFF80, 0xFE83, 0xFD89, 0xFC92, 0xFB9E, 0xFAAC, 0xF9BD, 0xF8D0,
+	0xF7E7, 0xF700, 0xF61B, 0xF539, 0xF459, 0xF37B, 0xF2A0, 0xF1C7,
+	0xF0F1, 0xF01D, 0xEF4A, 0xEE7A, 0xEDAD, 0xECE1, 0xEC17, 0xEB4F,
+	0xEA89, 0xE9C5, 0xE903, 0xE843, 0xE785, 0xE6C9, 0xE60E, 0xE555,
+	0xE49E, 0xE3E8, 0xE335, 0xE282, 0xE1D2, 0xE123, 0xE076, 0xDFCA,
+	0xDF20, 0xDE77, 0xDDD0, 0xDD2A, 0xDC85, 0xDBE3, 0xDB41, 0xDAA1,
+	0xDA02, 0xD965, 0xD8C9, 0xD82E, 0xD794, 0xD6FC, 0xD665, 0xD5CF,
+	0xD53B, 0xD4A7, 0xD415, 0xD384, 0xD2F4, 0xD266, 0xD1D8, 0xD14C,
+	0xD0C0, 0xD036, 0xCFAD, 0xCF25, 0xCE9E, 0xCE18, 0xCD93, 0xCD0E,
+	0xCC8B, 0xCC09, 0xCB88, 0xCB08, 0xCA89, 0xCA0A, 0xC98D, 0xC911,
+	0xC895, 0xC81A, 0xC7A0, 0xC728, 0xC6AF, 0xC638, 0xC5C2, 0xC54C,
+	0xC4D7, 0xC463, 0xC3F0, 0xC37E, 0xC30C, 0xC29B, 0xC22B, 0xC1BC,
+	0xC14D, 0xC0E0, 0xC072, 0xC006, 0xBF9A, 0xBF2F, 0xBEC5, 0xBE5B,
+	0xBDF3, 0xBD8A, 0xBD23, 0xBCBC, 0xBC56, 0xBBF0, 0xBB8B, 0xBB27,
+	0xBAC3, 0xBA60, 0xB9FD, 0xB99C, 0xB93A, 0xB8DA, 0xB879, 0xB81A,
+	0xB7BB, 0xB75D, 0xB6FF, 0xB6A2, 0xB645, 0xB5E9, 0xB58D, 0xB532,
+	0xB4AB, 0xB3F8, 0xB347, 0xB298, 0xB1EB, 0xB140, 0xB097, 0xAFF0,
+	0xAF4B, 0xAEA7, 0xAE06, 0xAD66, 0xACC8, 0xAC2B, 0xAB90, 0xAAF7,
+	0xAA5F, 0xA9C9, 0xA934, 0xA8A1, 0xA810, 0xA77F, 0xA6F1, 0xA663,
+	0xA5D8, 0xA54D, 0xA4C4, 0xA43C, 0xA3B6, 0xA330, 0xA2AC, 0xA22A,
+	0xA1A8, 0xA128, 0xA0A9, 0xA02B, 0x9FAE, 0x9F32, 0x9EB7, 0x9E3E,
+	0x9DC6, 0x9D4E, 0x9CD8, 0x9C63, 0x9BEF, 0x9B7B, 0x9B09, 0x9A98,
+	0x9A28, 0x99B8, 0x994A, 0x98DD, 0x9870, 0x9804, 0x979A, 0x9730,
+	0x96C7, 0x965E, 0x95F7, 0x9591, 0x952B, 0x94C6, 0x9462, 0x93FF,
+	0x939C, 0x933A, 0x92D9, 0x9279, 0x9219, 0x91BB, 0x915D, 0x90FF,
+	0x90A3, 0x9047, 0x8FEB, 0x8F91, 0x8F37, 0x8EDD, 0x8E85, 0x8E2D,
+	0x8DD5, 0x8D7E, 0x8D28, 0x8CD3, 0x8C7E, 0x8C2A, 0x8BD6, 0x8B83,
+	0x8B30, 0x8ADE, 0x8A8D, 0x8A3C, 0x89EB, 0x899C, 0x894C, 0x88FE,
+	0x88AF, 0x8862, 0x8815, 0x87C8, 0x877C, 0x8730, 0x86E5, 0x869A,
+	0x8650, 0x8606, 0x85BD, 0x8574, 0x852C, 0x84E4, 0x849D, 0x8456,
+	0x840F, 0x83C9, 0x8384, 0x833F, 0x82FA, 0x82B5, 0x8271, 0x822E,
+	0x81EB, 0x81A8, 0x8166, 0x8124, 0x80E2, 0x80A1, 0x8060, 0x8020,
+};
+
+/*
+ * Round a significand with its hidden bit at bit 'hidden' using the
+ * rounding bits 'rb' (with 'half' being the value of a tie) according
+ * to the rounding mode 'rm'. Returns the rounded significand, which may
+ * carry into bit 'hidden' + 1.
+ */
+static inline uint64_t fp_round_sig(bool sign, int rm, uint64_t sig,
+				    uint_fast32_t rb, uint_fast32_t half)
+{
+	switch (rm) {
+	case softfloat_round_near_even:
+		if (rb > half || (rb == half && (sig & 1)))
+			sig++;
+		break;
+	case softfloat_round_near_maxMag:
+		if (rb >= half)
+			sig++;
+		break;
+	case softfloat_round_min:
+		if (sign && rb)
+			sig++;
+		break;
+	case softfloat_round_max:
+		if (!sign && rb)
+			sig++;
+		break;
+	default:
+		break;
+	}
+
+	return sig;
+}
+
+#define FP_FAST_RM_OK(rm)	((unsigned int)(rm) <= softfloat_round_near_maxMag)
+
+/*
+ * The division and square root kernels are instantiated twice, once for
+ * round-to-nearest-even, in which fp_round_sig() reduces to the tie test,
+ * and once for the rounding mode passed at run time.
+ */
+#define FP_FAST_RM_DISPATCH(kernel, fallback, ...)			\
+	do {								\
+		int __rm = softfloat_roundingMode;			\
+		if (likely(__rm == softfloat_round_near_even))		\
+			return kernel(__VA_ARGS__,			\
+				      softfloat_round_near_even);	\
+		if (unlikely(!FP_FAST_RM_OK(__rm)))			\
+			return fallback(__VA_ARGS__);			\
+		return kernel(__VA_ARGS__, __rm);			\
+	} while (0)
+
+/* Approximate 2^62 / b for b in [2^31, 2^32) by Newton-Raphson iteration */
+static inline uint32_t fp_recip32(uint32_t b)
+{
+	uint32_t r = (uint32_t)fp_recip_seed[(b >> 23) & 0xFF] << 15;
+	int i;
+
+	for (i = 0; i < 2; i++)
+		r = ((uint64_t)r * (uint32_t)-(uint32_t)(((uint64_t)b * r) >> 31))
+		    >> 31;
+
+	return r;
+}
+
+/* Approximate 2^62 / sqrt(x) for x in [2^30, 2^32) */
+static inline uint32_t fp_rsqrt32(uint32_t x)
+{
+	uint32_t y = (uint32_t)fp_rsqrt_seed[(x >> 31) ? 0x80 | ((x >> 24) & 0x7F)
+						   : (x >> 23) & 0x7F] << 15;
+	uint32_t y2;
+	int64_t d;
+	int i;
+
+	/* y' = y * (3 - x * y^2) / 2 */
+	for (i = 0; i < 2; i++) {
+		y2 = ((uint64_t)y * y) >> 31;
+		d = (int64_t)0x80000000 - (int64_t)(((uint64_t)x * y2) >> 30);
+		y = ((uint64_t)y * (uint32_t)(0x80000000 + (d >> 1))) >> 31;
+	}
+
+	return y;
+}
+
+static inline __attribute__((always_inline))
+float32_t fp_f32_div_rm(float32_t a, float32_t b, int rm)
+{
+	uint32_t uiA = a.v, uiB = b.v, sigA, sigB, sig;
+	int_fast16_t expA = expF32UI(uiA), expB = expF32UI(uiB), exp;
+	uint_fast32_t rb;
+	uint64_t num, q;
+	int64_t rem;
+	float32_t z;
+	bool sign;
+
+	if (unlikely(!F32_IS_NORMAL(expA) || !F32_IS_NORMAL(expB)))
+		return f32_div(a, b);
+
+	sign = signF32UI(uiA) ^ signF32UI(uiB);
+	sigA = fracF32UI(uiA) | 0x00800000;
+	sigB = fracF32UI(uiB) | 0x00800000;
+	exp = expA - expB + 0x7F;
+	if (sigA < sigB) {
+		sigA <<= 1;
+		exp--;
+	}
+	if (unlikely(exp < 1 || exp >= 0xFF))
+		return f32_div(a, b);
+
+	/*
+	 * q approximates sigA * 2^25 / sigB in [2^25, 2^26) from below, the
+	 * remainder brings it to the exact truncated quotient.
+	 */
+	num = (uint64_t)sigA << 25;
+	q = ((uint64_t)sigA * fp_recip32(sigB << 8)) >> 29;
+	rem = num - q * sigB;
+	while (rem < 0) {
+		q--;
+		rem += sigB;
+	}
+	while (rem >= (int64_t)sigB) {
+		q++;
+		rem -= sigB;
+	}
+
+	rb = ((q & 3) << 1) | (rem != 0);
+	sig = fp_round_sig(sign, rm, q >> 2, rb, 4);
+	if (sig >> 24) {
+		sig >>= 1;
+		exp++;
+	}
+	if (unlikely(exp >= 0xFF))
+		return f32_div(a, b);
+
+	if (rb)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF32UI(sign, exp - 1, sig);
+	return z;
+}
+
+float32_t fp_fast_f32_div(float32_t a, float32_t b)
+{
+	FP_FAST_RM_DISPATCH(fp_f32_div_rm, f32_div, a, b);
+}
+
+static inline __attribute__((always_inline))
+float32_t fp_f32_sqrt_rm(float32_t a, int rm)
+{
+	uint32_t uiA = a.v, sigA, sig;
+	int_fast16_t expA = expF32UI(uiA), exp;
+	uint_fast32_t rb;
+	uint64_t x, s;
+	int64_t rem;
+	float32_t z;
+
+	if (unlikely(signF32UI(uiA) || !F32_IS_NORMAL(expA)))
+		return f32_sqrt(a);
+
+	/* Make the exponent even, sigA is then in [2^23, 2^25) */
+	exp = ((expA - 0x7F) >> 1) + 0x7F;
+	sigA = fracF32UI(uiA) | 0x00800000;
+	if (!(expA & 1))
+		sigA <<= 1;
+
+	/* s approximates sqrt(sigA * 2^27) in [2^25, 2^26) */
+	x = (uint64_t)sigA << 27;
+	s = ((uint64_t)(sigA << 7) * fp_rsqrt32(sigA << 7)) >> 36;
+	rem = x - s * s;
+	while (rem < 0) {
+		s--;
+		rem += 2 * s + 1;
+	}
+	while (rem > (int64_t)(2 * s)) {
+		rem -= 2 * s + 1;
+		s++;
+	}
+
+	rb = ((s & 3) << 1) | (rem != 0);
+	sig = fp_round_sig(false, rm, s >> 2, rb, 4);
+	if (sig >> 24) {
+		sig >>= 1;
+		exp++;
+	}
+
+	if (rb)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF32UI(0, exp - 1, sig);
+	return z;
+}
+
+float32_t fp_fast_f32_sqrt(float32_t a)
+{
+	FP_FAST_RM_DISPATCH(fp_f32_sqrt_rm, f32_sqrt, a);
+}
+
+#ifdef SBI_ENABLE_FP_FAST_F64_DIV_SQRT
+#ifdef __SIZEOF_INT128__
+
+/*
+ * Approximate 2^126 / b for b in [2^63, 2^64). The 32-bit kernel gives
+ * about 30 bits, one more Newton-Raphson step doubles that.
+ */
+static inline uint64_t fp_recip64(uint64_t b)
+{
+	uint64_t r = (uint64_t)fp_recip32(b >> 32) << 32;
+
+	return ((unsigned __int128)r *
+		(uint64_t)-(uint64_t)(((unsigned __int128)b * r) >> 63)) >> 63;
+}
+
+/* Approximate 2^126 / sqrt(x) for x in [2^62, 2^64), as fp_recip64() */
+static inline uint64_t fp_rsqrt64(uint64_t x)
+{
+	uint64_t y = (uint64_t)fp_rsqrt32(x >> 32) << 32;
+	uint64_t y2 = ((unsigned __int128)y * y) >> 63;
+	int64_t d = (int64_t)(UINT64_C(0x8000000000000000) -
+			      (uint64_t)(((unsigned __int128)x * y2) >> 62));
+
+	/* y' = y * (3 - x * y^2) / 2 */
+	return ((unsigned __int128)y *
+		(UINT64_C(0x8000000000000000) + (d >> 1))) >> 63;
+}
+
+#endif
+
+static inline __attribute__((always_inline))
+float64_t fp_f64_div_rm(float64_t a, float64_t b, int rm)
+{
+#ifdef __SIZEOF_INT128__
+	uint64_t uiA = a.v, uiB = b.v, sigA, sigB, sig, q;
+	int_fast16_t expA = expF64UI(uiA), expB = expF64UI(uiB), exp;
+	uint_fast32_t rb;
+	int64_t rem;
+	float64_t z;
+	bool sign;
+
+	if (unlikely(!F64_IS_NORMAL(expA) || !F64_IS_NORMAL(expB)))
+		return f64_div(a, b);
+
+	sign = signF64UI(uiA) ^ signF64UI(uiB);
+	sigA = fracF64UI(uiA) | UINT64_C(0x0010000000000000);
+	sigB = fracF64UI(uiB) | UINT64_C(0x0010000000000000);
+	exp = expA - expB + 0x3FF;
+	if (sigA < sigB) {
+		sigA <<= 1;
+		exp--;
+	}
+	if (unlikely(exp < 1 || exp >= 0x7FF))
+		return f64_div(a, b);
+
+	/*
+	 * q approximates sigA * 2^54 / sigB in [2^54, 2^55) from below, the
+	 * remainder brings it to the exact truncated quotient. The remainder
+	 * is only a few multiples of sigB, so 64-bit arithmetic is enough.
+	 */
+	q = ((unsigned __int128)sigA * fp_recip64(sigB << 11)) >> 61;
+	rem = (sigA << 54) - q * sigB;
+	while (rem < 0) {
+		q--;
+		rem += sigB;
+	}
+	while (rem >= (int64_t)sigB) {
+		q++;
+		rem -= sigB;
+	}
+
+	rb = ((q & 3) << 1) | (rem != 0);
+	sig = fp_round_sig(sign, rm, q >> 2, rb, 4);
+	if (sig >> 53) {
+		sig >>= 1;
+		exp++;
+	}
+	if (unlikely(exp >= 0x7FF))
+		return f64_div(a, b);
+
+	if (rb)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF64UI(sign, exp - 1, sig);
+	return z;
+#else
+	return f64_div(a, b);
+#endif
+}
+
+float64_t fp_fast_f64_div(float64_t a, float64_t b)
+{
+	FP_FAST_RM_DISPATCH(fp_f64_div_rm, f64_div, a, b);
+}
+
+static inline __attribute__((always_inline))
+float64_t fp_f64_sqrt_rm(float64_t a, int rm)
+{
+#ifdef __SIZEOF_INT128__
+	uint64_t uiA = a.v, sigA, sig, s;
+	int_fast16_t expA = expF64UI(uiA), exp;
+	uint_fast32_t rb;
+	int64_t rem;
+	float64_t z;
+
+	if (unlikely(signF64UI(uiA) || !F64_IS_NORMAL(expA)))
+		return f64_sqrt(a);
+
+	/* Make the exponent even, sigA is then in [2^52, 2^54) */
+	exp = ((expA - 0x3FF) >> 1) + 0x3FF;
+	sigA = fracF64UI(uiA) | UINT64_C(0x0010000000000000);
+	if (!(expA & 1))
+		sigA <<= 1;
+
+	/* s approximates sqrt(sigA * 2^56) in [2^54, 2^55), as above */
+	s = ((unsigned __int128)(sigA << 10) * fp_rsqrt64(sigA << 10)) >> 71;
+	rem = (sigA << 56) - s * s;
+	while (rem < 0) {
+		s--;
+		rem += 2 * s + 1;
+	}
+	while (rem > (int64_t)(2 * s)) {
+		rem -= 2 * s + 1;
+		s++;
+	}
+
+	rb = ((s & 3) << 1) | (rem != 0);
+	sig = fp_round_sig(false, rm, s >> 2, rb, 4);
+	if (sig >> 53) {
+		sig >>= 1;
+		exp++;
+	}
+
+	if (rb)
+		softfloat_raiseFlags(softfloat_flag_inexact);
+	z.v = packToF64UI(0, exp - 1, sig);
+	return z;
+#else
+	return f64_sqrt(a);
+#endif
+}
+
+float64_t fp_fast_f64_sqrt(float64_t a)
+{
+	FP_FAST_RM_DISPATCH(fp_f64_sqrt_rm, f64_sqrt, a);
+}
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fp_qreg.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION) && \
+    defined(SBI_ENABLE_FP_EMULATION_Q)
+
+#define FP_QREG_COUNT	32
+
+static unsigned long fp_qreg_off;
+
+u64 *sbi_fp_qreg_hi(void)
+{
+	return sbi_scratch_offset_ptr(sbi_scratch_thishart_ptr(), fp_qreg_off);
+}
+
+int sbi_fp_qreg_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	if (cold_boot) {
+		fp_qreg_off = sbi_scratch_alloc_offset(FP_QREG_COUNT *
+						       sizeof(u64));
+		if (!fp_qreg_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!fp_qreg_off)
+			return SBI_ENOMEM;
+	}
+
+	sbi_memset(sbi_scratch_offset_ptr(scratch, fp_qreg_off), 0,
+		   FP_QREG_COUNT * sizeof(u64));
+
+	return 0;
+}
+
+#endif
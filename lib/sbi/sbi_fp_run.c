@@ -0,0 +1,390 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fp_run.h>
+#include <sbi/sbi_illegal_insn.h>
+#include <sbi/sbi_pmu.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_trap.h>
+#include <sbi/sbi_unpriv.h>
+
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+
+/* Maximum number of instructions emulated within a single FP trap */
+#define FP_RUN_AHEAD_MAX	64
+
+/* Number of entries in the per-HART decoded FP instruction cache */
+#define FP_ICACHE_ENTRIES	16
+
+#define FP_UOP_REG(insn, pos)	(1U << (((insn) >> (pos)) & 0x1f))
+
+/** Pre-decoded instruction of an FP run */
+struct fp_uop {
+	/* Instruction encoding, the only input of the decode */
+	u32 insn;
+	/* Mask of integer registers accessed by the instruction */
+	u32 int_regs;
+	/* PMU firmware event of the instruction class (SBI_PMU_FW_MAX if none) */
+	u32 event;
+	/* Emulation routine (NULL if the instruction ends a run) */
+	illegal_insn_func handler;
+	/* OP-FP routine called through fp_opcode_exec() */
+	illegal_insn_func leaf;
+};
+
+static unsigned long fp_icache_off;
+
+/*
+ * Emulate an integer instruction accepted by fp_uop_decode(). Writes
+ * to x0 are dropped because its save slot holds the emulated FCSR.
+ */
+static int fp_run_int_insn(ulong insn, struct sbi_trap_regs *regs)
+{
+	ulong rs1 = GET_RS1(insn, regs), op2, val = 0;
+	bool is_op = (insn & 0x20) != 0, alt = (insn >> 30) & 1;
+
+	switch (insn & 0x7f) {
+	case 0x17: /* AUIPC */
+		val = regs->mepc + (long)(s32)(insn & 0xfffff000);
+		break;
+	case 0x37: /* LUI */
+		val = (long)(s32)(insn & 0xfffff000);
+		break;
+	case 0x13: /* OP-IMM */
+	case 0x33: /* OP */
+		op2 = is_op ? GET_RS2(insn, regs) : (ulong)IMM_I(insn);
+		switch (GET_RM(insn)) {
+		case 0:
+			val = (is_op && alt) ? rs1 - op2 : rs1 + op2;
+			break;
+		case 1:
+			val = rs1 << (op2 & (__riscv_xlen - 1));
+			break;
+		case 2:
+			val = (long)rs1 < (long)op2;
+			break;
+		case 3:
+			val = rs1 < op2;
+			break;
+		case 4:
+			val = rs1 ^ op2;
+			break;
+		case 5:
+			if (alt)
+				val = (long)rs1 >> (op2 & (__riscv_xlen - 1));
+			else
+				val = rs1 >> (op2 & (__riscv_xlen - 1));
+			break;
+		case 6:
+			val = rs1 | op2;
+			break;
+		case 7:
+			val = rs1 & op2;
+			break;
+		}
+		break;
+#if __riscv_xlen == 64
+	case 0x1b: /* OP-IMM-32 */
+	case 0x3b: /* OP-32 */
+		op2 = is_op ? GET_RS2(insn, regs) : (ulong)IMM_I(insn);
+		switch (GET_RM(insn)) {
+		case 0:
+			val = (s32)((is_op && alt) ? rs1 - op2 : rs1 + op2);
+			break;
+		case 1:
+			val = (s32)((u32)rs1 << (op2 & 0x1f));
+			break;
+		case 5:
+			if (alt)
+				val = (s32)rs1 >> (op2 & 0x1f);
+			else
+				val = (s32)((u32)rs1 >> (op2 & 0x1f));
+			break;
+		}
+		break;
+#endif
+	}
+
+	if ((insn >> SH_RD) & 0x1f)
+		SET_RD(insn, regs, val);
+
+	regs->mepc += 4;
+
+	return 0;
+}
+
+static int fp_run_rvc_insn(ulong insn, struct sbi_trap_regs *regs)
+{
+	return emulate_rvc(insn, 0, 0, regs);
+}
+
+/* PMU firmware event counting an OP-FP instruction */
+static u32 fp_uop_op_event(ulong insn)
+{
+	switch (insn >> 27) {
+	case 0x00: /* FADD */
+	case 0x01: /* FSUB */
+		return SBI_PMU_FW_FP_EMUL_ADD;
+	case 0x02: /* FMUL */
+		return SBI_PMU_FW_FP_EMUL_MUL;
+	case 0x03: /* FDIV */
+		return SBI_PMU_FW_FP_EMUL_DIV;
+	case 0x0b: /* FSQRT */
+		return SBI_PMU_FW_FP_EMUL_SQRT;
+	case 0x08: /* FCVT between FP formats */
+	case 0x18: /* FCVT to integer */
+	case 0x1a: /* FCVT from integer */
+		return SBI_PMU_FW_FP_EMUL_CVT;
+	case 0x05: /* FMIN/FMAX */
+	case 0x14: /* FEQ/FLT/FLE */
+		return SBI_PMU_FW_FP_EMUL_CMP;
+	case 0x1c: /* FMV.X or FCLASS */
+		return (GET_RM(insn) == 1) ? SBI_PMU_FW_FP_EMUL_CMP :
+					     SBI_PMU_FW_FP_EMUL_MOVE;
+	case 0x04: /* FSGNJ */
+	case 0x1e: /* FMV from X */
+		return SBI_PMU_FW_FP_EMUL_MOVE;
+	default:
+		return SBI_PMU_FW_MAX;
+	}
+}
+
+/*
+ * Decode an instruction of an FP run. Besides FP instructions, a run
+ * covers FP CSR accesses and simple integer instructions without control
+ * flow or memory side effects. Any other instruction is decoded without
+ * a handler so that it ends the run.
+ */
+static void fp_uop_decode(ulong insn, struct fp_uop *uop)
+{
+	ulong funct3 = GET_RM(insn), funct7 = insn >> 25, csr_num;
+	u32 rd = FP_UOP_REG(insn, SH_RD), rs1 = FP_UOP_REG(insn, SH_RS1);
+	u32 rs2 = FP_UOP_REG(insn, SH_RS2);
+
+	uop->insn = insn;
+	uop->int_regs = 0;
+	uop->event = SBI_PMU_FW_MAX;
+	uop->handler = NULL;
+	uop->leaf = NULL;
+
+	if ((insn & 3) != 3) {
+		if ((insn & INSN_MASK_C_FLD) == INSN_MATCH_C_FLD ||
+		    (insn & INSN_MASK_C_FSD) == INSN_MATCH_C_FSD) {
+			uop->int_regs = 1U << RVC_RS1S(insn);
+			uop->handler = fp_run_rvc_insn;
+		} else if ((insn & INSN_MASK_C_FLDSP) == INSN_MATCH_C_FLDSP ||
+			   (insn & INSN_MASK_C_FSDSP) == INSN_MATCH_C_FSDSP) {
+			uop->handler = fp_run_rvc_insn;
+		}
+		if (uop->handler)
+			uop->event = (insn & 0x8000) ? SBI_PMU_FW_FP_EMUL_STORE :
+						       SBI_PMU_FW_FP_EMUL_LOAD;
+		return;
+	}
+
+	switch (insn & 0x7f) {
+	case 0x43: /* FMADD */
+	case 0x47: /* FMSUB */
+	case 0x4b: /* FNMSUB */
+	case 0x4f: /* FNMADD */
+		uop->event = SBI_PMU_FW_FP_EMUL_FMA;
+		uop->handler = fmadd_opcode_insn;
+		break;
+	case 0x53: /* OP-FP */
+		if ((insn >> 27) >= 0x14)
+			uop->int_regs = rd | rs1;
+		uop->event = fp_uop_op_event(insn);
+		uop->leaf = fp_opcode_decode(insn);
+		break;
+	case 0x07: /* LOAD-FP */
+		uop->int_regs = rs1;
+		uop->event = SBI_PMU_FW_FP_EMUL_LOAD;
+		uop->handler = float_load_opcode_insn;
+		break;
+	case 0x27: /* STORE-FP */
+		uop->int_regs = rs1;
+		uop->event = SBI_PMU_FW_FP_EMUL_STORE;
+		uop->handler = float_store_opcode_insn;
+		break;
+	case 0x73: /* SYSTEM */
+		csr_num = (u32)insn >> 20;
+		if (csr_num < CSR_FFLAGS || CSR_FCSR < csr_num ||
+		    funct3 == 0 || funct3 == 4)
+			break;
+		uop->int_regs = rd | rs1;
+		uop->handler = system_opcode_insn;
+		break;
+	case 0x17: /* AUIPC */
+	case 0x37: /* LUI */
+		uop->int_regs = rd;
+		uop->handler = fp_run_int_insn;
+		break;
+	case 0x13: /* OP-IMM */
+		if ((funct3 == 1 && (insn >> 26) != 0) ||
+		    (funct3 == 5 && (insn >> 26) != 0 && (insn >> 26) != 0x10))
+			break;
+		uop->int_regs = rd | rs1;
+		uop->handler = fp_run_int_insn;
+		break;
+	case 0x33: /* OP */
+		if (funct7 != 0 &&
+		    !(funct7 == 0x20 && (funct3 == 0 || funct3 == 5)))
+			break;
+		uop->int_regs = rd | rs1 | rs2;
+		uop->handler = fp_run_int_insn;
+		break;
+#if __riscv_xlen == 64
+	case 0x1b: /* OP-IMM-32 */
+		if ((funct3 != 0 && funct3 != 1 && funct3 != 5) ||
+		    (funct3 == 1 && funct7 != 0) ||
+		    (funct3 == 5 && funct7 != 0 && funct7 != 0x20))
+			break;
+		uop->int_regs = rd | rs1;
+		uop->handler = fp_run_int_insn;
+		break;
+	case 0x3b: /* OP-32 */
+		if ((funct3 != 0 && funct3 != 1 && funct3 != 5) ||
+		    (funct7 != 0 &&
+		     !(funct7 == 0x20 && (funct3 == 0 || funct3 == 5))))
+			break;
+		uop->int_regs = rd | rs1 | rs2;
+		uop->handler = fp_run_int_insn;
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+static inline bool fp_uop_runnable(struct fp_uop *uop, ulong unsaved)
+{
+	return (uop->handler || uop->leaf) && !(uop->int_regs & unsaved);
+}
+
+static inline int fp_uop_exec(struct fp_uop *uop, struct sbi_trap_regs *regs)
+{
+	if (uop->leaf)
+		return fp_opcode_exec(uop->leaf, uop->insn, regs);
+
+	return uop->handler(uop->insn, regs);
+}
+
+/*
+ * Index the decoded instruction cache by instruction address. Bit 1 can
+ * only be set with compressed code, so it is folded into the top index
+ * bit. 4-byte code then uses every entry instead of every other one.
+ */
+static inline struct fp_uop *fp_icache_entry(struct fp_uop *icache, ulong epc)
+{
+	ulong idx = (epc >> 2) ^ ((epc & 2) * (FP_ICACHE_ENTRIES / 4));
+
+	return &icache[idx & (FP_ICACHE_ENTRIES - 1)];
+}
+
+/*
+ * Emulate a run of FP instructions starting with the trapped instruction.
+ * After each emulated instruction, the next one is fetched, decoded unless
+ * the decoded instruction cache holds the same encoding, and emulated as
+ * well if it is runnable. The run ends early when a trap is redirected,
+ * an interrupt becomes pending, the next instruction is not entirely
+ * within the page of the trapped instruction or cannot be fetched.
+ * The M-mode cycles spent in the run are added to SBI_PMU_FW_FP_EMUL_CYCLES.
+ *
+ * Returns SBI_ENOTSUPP if the trapped instruction itself is not runnable.
+ */
+int sbi_fp_emulate_run(ulong insn, struct sbi_trap_regs *regs, ulong unsaved)
+{
+	struct fp_uop *icache = sbi_scratch_thishart_offset_ptr(fp_icache_off);
+	struct sbi_trap_info uptrap;
+	ulong next_mepc, page, start;
+	struct fp_uop *uop;
+	int rc, count = 0;
+
+	uop = fp_icache_entry(icache, regs->mepc);
+	if (uop->insn != insn)
+		fp_uop_decode(insn, uop);
+	if (!fp_uop_runnable(uop, unsaved))
+		return SBI_ENOTSUPP;
+
+	page = regs->mepc & PAGE_MASK;
+	start = csr_read(CSR_MCYCLE);
+	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_FP_EMUL_RUN);
+
+	while (1) {
+		next_mepc = regs->mepc + (((uop->insn & 3) == 3) ? 4 : 2);
+		rc = fp_uop_exec(uop, regs);
+		/*
+		 * An FP CSR access or FP to integer instruction with rd = x0
+		 * writes the save slot of x0, which the next instructions of
+		 * the run read as x0.
+		 */
+		regs->zero = 0;
+		sbi_pmu_ctr_incr_fw(SBI_PMU_FW_FP_EMUL_INSN);
+		if (uop->event != SBI_PMU_FW_MAX)
+			sbi_pmu_ctr_incr_fw(uop->event);
+
+		if (rc || regs->mepc != next_mepc ||
+		    ++count >= FP_RUN_AHEAD_MAX)
+			break;
+
+		if (csr_read(CSR_MIP) & csr_read(CSR_MIE))
+			break;
+
+		/*
+		 * sbi_get_insn() only needs read permission. The HART fetched
+		 * the trapped instruction with execute permission, so the run
+		 * stays within the page of the trapped instruction.
+		 */
+		if ((next_mepc & PAGE_MASK) != page)
+			break;
+
+		/*
+		 * Always fetch the instruction, the code may have been
+		 * modified or remapped since the cached entry was decoded.
+		 */
+		insn = sbi_get_insn(next_mepc, &uptrap);
+		if (uptrap.cause ||
+		    (((insn & 3) == 3) && ((next_mepc + 2) & PAGE_MASK) != page))
+			break;
+		uop = fp_icache_entry(icache, next_mepc);
+		if (uop->insn != insn)
+			fp_uop_decode(insn, uop);
+
+		if (!fp_uop_runnable(uop, unsaved))
+			break;
+	}
+
+	sbi_pmu_ctr_add_fw(SBI_PMU_FW_FP_EMUL_CYCLES,
+			   csr_read(CSR_MCYCLE) - start);
+
+	return rc;
+}
+
+int sbi_fp_icache_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct fp_uop *icache;
+
+	if (cold_boot) {
+		fp_icache_off = sbi_scratch_alloc_offset(FP_ICACHE_ENTRIES *
+							 sizeof(*icache));
+		if (!fp_icache_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!fp_icache_off)
+			return SBI_ENOMEM;
+	}
+
+	icache = sbi_scratch_offset_ptr(scratch, fp_icache_off);
+	sbi_memset(icache, 0, FP_ICACHE_ENTRIES * sizeof(*icache));
+
+	return 0;
+}
+
+#endif
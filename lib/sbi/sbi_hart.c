@@ -544,6 +544,8 @@ int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot)
 
 void __attribute__((noreturn)) sbi_hart_hang(void)
 {
+	sbi_console_flush();
+
 	while (1)
 		wfi();
 	__builtin_unreachable();
@@ -560,6 +562,12 @@ sbi_hart_switch_mode(unsigned long arg0, unsigned long arg1,
 	unsigned long val;
 #endif
 
+	/*
+	 * The next stage may drive the console device directly, so do not
+	 * leave buffered output (such as the boot banner) behind.
+	 */
+	sbi_console_flush();
+
 	switch (next_mode) {
 	case PRV_M:
 		break;
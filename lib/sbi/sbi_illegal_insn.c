@@ -11,15 +11,18 @@
 #include <sbi/riscv_encoding.h>
 #include <sbi/riscv_fp.h>
 #include <sbi/sbi_bitops.h>
+#include <sbi/sbi_console.h>
 #include <sbi/sbi_emulate_csr.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_fp_emulation.h>
+#include <sbi/sbi_fp_run.h>
 #include <sbi/sbi_illegal_insn.h>
 #include <sbi/sbi_misaligned_ldst.h>
 #include <sbi/sbi_pmu.h>
 #include <sbi/sbi_trap.h>
 #include <sbi/sbi_unpriv.h>
 #include <sbi_utils/softfloat/internals.h>
+#include <sbi_utils/softfloat/softfloat.h>
 
 int truly_illegal_insn(ulong insn, struct sbi_trap_regs *regs)
 {
@@ -102,6 +105,21 @@ int fmadd_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 		uint64_t rs2 = GET_F64_RS2(insn, regs);
 		uint64_t rs3 = GET_F64_RS3(insn, regs) ^ (negC ? INT64_MIN : 0);
 		SET_F64_RD(insn, regs, softfloat_mulAddF64(rs1, rs2, rs3, 0).v);
+	} else if (GET_PRECISION(insn) == PRECISION_H) {
+		uint16_t rs1 = GET_F16_RS1(insn, regs) ^ (negA ? 0x8000 : 0);
+		uint16_t rs2 = GET_F16_RS2(insn, regs);
+		uint16_t rs3 = GET_F16_RS3(insn, regs) ^ (negC ? 0x8000 : 0);
+		SET_F16_RD(insn, regs, softfloat_mulAddF16(rs1, rs2, rs3, 0).v);
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	} else if (GET_PRECISION(insn) == PRECISION_Q) {
+		float128_t rs1 = GET_F128_RS1(insn, regs);
+		float128_t rs2 = GET_F128_RS2(insn, regs);
+		float128_t rs3 = GET_F128_RS3(insn, regs), rd;
+		rs1.v[1] ^= negA ? INT64_MIN : 0;
+		rs3.v[1] ^= negC ? INT64_MIN : 0;
+		f128M_mulAdd(&rs1, &rs2, &rs3, &rd);
+		SET_F128_RD(insn, regs, rd);
+#endif
 	} else {
 		return truly_illegal_insn(insn, regs);
 	}
@@ -111,8 +129,6 @@ int fmadd_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 	return 0;
 }
 
-int fp_opcode_insn(ulong insn, struct sbi_trap_regs *regs);
-
 #ifndef __riscv_flen
 int float_store_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 {
@@ -125,6 +141,15 @@ int float_store_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 		return truly_illegal_insn(insn, regs);
 
 	switch (insn & MASK_FUNCT3) {
+	case INSN_MATCH_FSH & MASK_FUNCT3:
+		punt_to_misaligned_handler(2, sbi_misaligned_store_handler);
+		sbi_store_u16((void *)addr, GET_F32_RS2(insn, regs), &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		break;
+
 	case INSN_MATCH_FSW & MASK_FUNCT3:
 		punt_to_misaligned_handler(4, sbi_misaligned_store_handler);
 		sbi_store_u32((void *)addr, GET_F32_RS2(insn, regs), &uptrap);
@@ -143,6 +168,21 @@ int float_store_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 		}
 		break;
 
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	case INSN_MATCH_FSQ & MASK_FUNCT3:
+		/* misaligned FSQ is not emulated and traps to S-mode */
+		punt_to_misaligned_handler(8, sbi_misaligned_store_handler);
+		sbi_store_u64((void *)addr, GET_F64_RS2(insn, regs), &uptrap);
+		if (!uptrap.cause)
+			sbi_store_u64((void *)(addr + 8), GET_FQ_HI(insn, 20),
+				      &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		break;
+#endif
+
 	default:
 		return truly_illegal_insn(insn, regs);
 	}
@@ -157,22 +197,61 @@ int float_load_opcode_insn(ulong insn, struct sbi_trap_regs *regs)
 	ulong tval2 = 0, tinst = 0; // TODO: Hypervisor
 	uintptr_t addr = GET_RS1(insn, regs) + IMM_I(insn);
 	struct sbi_trap_info uptrap = {};
+	u64 data;
 
 	// if FPU is disabled, punt back to the OS
 	if (unlikely((regs->mstatus & MSTATUS_FS) == 0))
 		return truly_illegal_insn(insn, regs);
 
 	switch (insn & MASK_FUNCT3) {
+	case INSN_MATCH_FLH & MASK_FUNCT3:
+		punt_to_misaligned_handler(2, sbi_misaligned_load_handler);
+		data = sbi_load_u16((void *)addr, &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		SET_F16_RD(insn, regs, data);
+		break;
+
 	case INSN_MATCH_FLW & MASK_FUNCT3:
 		punt_to_misaligned_handler(4, sbi_misaligned_load_handler);
-		SET_F32_RD(insn, regs, sbi_load_s32((void *)addr, &uptrap));
+		data = (u32)sbi_load_s32((void *)addr, &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		SET_F32_RD(insn, regs, data);
 		break;
 
 	case INSN_MATCH_FLD & MASK_FUNCT3:
 		punt_to_misaligned_handler(sizeof(uintptr_t),
 					   sbi_misaligned_load_handler);
-		SET_F64_RD(insn, regs, sbi_load_u64((void *)addr, &uptrap));
+		data = sbi_load_u64((void *)addr, &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		SET_F64_RD(insn, regs, data);
+		break;
+
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	case INSN_MATCH_FLQ & MASK_FUNCT3: {
+		float128_t val;
+
+		/* misaligned FLQ is not emulated and traps to S-mode */
+		punt_to_misaligned_handler(8, sbi_misaligned_load_handler);
+		val.v[0] = sbi_load_u64((void *)addr, &uptrap);
+		if (!uptrap.cause)
+			val.v[1] = sbi_load_u64((void *)(addr + 8), &uptrap);
+		if (uptrap.cause) {
+			uptrap.epc = regs->mepc;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+		SET_F128_RD(insn, regs, val);
 		break;
+	}
+#endif
 
 	default:
 		return truly_illegal_insn(insn, regs);
@@ -192,6 +271,8 @@ int emulate_rvc(ulong insn, ulong tval2, ulong tinst,
 	struct sbi_trap_info uptrap = {};
 	// the only emulable RVC instructions are FP loads and stores.
 #if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+	u64 data;
+
 	csr_write(CSR_MEPC, regs->mepc + 2);
 
 	// if FPU is disabled, punt back to the OS
@@ -202,13 +283,16 @@ int emulate_rvc(ulong insn, ulong tval2, ulong tinst,
 		uintptr_t addr = GET_RS1S(insn, regs) + RVC_LD_IMM(insn);
 		if (unlikely(addr % sizeof(uintptr_t)))
 			return sbi_misaligned_load_handler(addr, tval2, tinst, regs);
-		SET_F64_RD(RVC_RS2S(insn) << SH_RD, regs,
-			   sbi_load_u64((void *)addr, &uptrap));
+		data = sbi_load_u64((void *)addr, &uptrap);
+		if (!uptrap.cause)
+			SET_F64_RD(RVC_RS2S(insn) << SH_RD, regs, data);
 	} else if ((insn & INSN_MASK_C_FLDSP) == INSN_MATCH_C_FLDSP) {
 		uintptr_t addr = GET_SP(regs) + RVC_LDSP_IMM(insn);
 		if (unlikely(addr % sizeof(uintptr_t)))
 			return sbi_misaligned_load_handler(addr, tval2, tinst, regs);
-		SET_F64_RD(insn, regs, sbi_load_u64((void *)addr, &uptrap));
+		data = sbi_load_u64((void *)addr, &uptrap);
+		if (!uptrap.cause)
+			SET_F64_RD(insn, regs, data);
 	} else if ((insn & INSN_MASK_C_FSD) == INSN_MATCH_C_FSD) {
 		uintptr_t addr = GET_RS1S(insn, regs) + RVC_LD_IMM(insn);
 		if (unlikely(addr % sizeof(uintptr_t)))
@@ -229,13 +313,16 @@ int emulate_rvc(ulong insn, ulong tval2, ulong tinst,
 		uintptr_t addr = GET_RS1S(insn, regs) + RVC_LW_IMM(insn);
 		if (unlikely(addr % 4))
 			return sbi_misaligned_load_handler(addr, tval2, tinst, regs);
-		SET_F32_RD(RVC_RS2S(insn) << SH_RD, regs,
-			   sbi_load_s32((void *)addr, &uptrap));
+		data = (u32)sbi_load_s32((void *)addr, &uptrap);
+		if (!uptrap.cause)
+			SET_F32_RD(RVC_RS2S(insn) << SH_RD, regs, data);
 	} else if ((insn & INSN_MASK_C_FLWSP) == INSN_MATCH_C_FLWSP) {
 		uintptr_t addr = GET_SP(regs) + RVC_LWSP_IMM(insn);
 		if (unlikely(addr % 4))
 			return sbi_misaligned_load_handler(addr, tval2, tinst, regs);
-		SET_F32_RD(insn, regs, load_int32_t((void *)addr, &uptrap));
+		data = (u32)sbi_load_s32((void *)addr, &uptrap);
+		if (!uptrap.cause)
+			SET_F32_RD(insn, regs, data);
 	} else if ((insn & INSN_MASK_C_FSW) == INSN_MATCH_C_FSW) {
 		uintptr_t addr = GET_RS1S(insn, regs) + RVC_LW_IMM(insn);
 		if (unlikely(addr % 4))
@@ -324,6 +411,9 @@ int sbi_illegal_insn_handler(ulong insn, ulong tval2, ulong tinst,
 			     struct sbi_trap_regs *regs)
 {
 	struct sbi_trap_info uptrap;
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+	int rc;
+#endif
 
 	/*
 	 * We only deal with 32-bit (or longer) illegal instructions. If we
@@ -343,9 +433,39 @@ int sbi_illegal_insn_handler(ulong insn, ulong tval2, ulong tinst,
 			uptrap.epc = regs->mepc;
 			return sbi_trap_redirect(regs, &uptrap);
 		}
-		if ((insn & 3) != 3)
-			return emulate_rvc(insn, tval2, tinst, regs);
 	}
 
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+	if (((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) != PRV_M) {
+		rc = sbi_fp_emulate_run(insn, regs, 0);
+		if (rc != SBI_ENOTSUPP)
+			return rc;
+	}
+#endif
+
+	if ((insn & 3) != 3)
+		return emulate_rvc(insn, tval2, tinst, regs);
+
 	return illegal_insn_table[(insn & 0x7c) >> 2](insn, regs);
 }
+
+#if !defined(__riscv_flen) && defined(SBI_ENABLE_FP_EMULATION)
+struct sbi_trap_regs *sbi_fp_trap_handler(ulong insn,
+					  struct sbi_trap_regs *regs)
+{
+	/*
+	 * Called directly from the trap vector for FP instructions trapped
+	 * from S/U-mode. Only caller-saved registers are present in regs and
+	 * the trap vector has already checked that the instruction does not
+	 * refer to any other integer register. Redirecting a trap to S/U-mode
+	 * cannot fail so the return value of the handler is not needed.
+	 */
+	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_ILLEGAL_INSN);
+	if (sbi_fp_emulate_run(insn, regs, SBI_TRAP_FP_FAST_UNSAVED_REGS) ==
+	    SBI_ENOTSUPP)
+		illegal_insn_table[(insn & 0x7c) >> 2](insn, regs);
+	sbi_console_drain();
+
+	return regs;
+}
+#endif
@@ -69,9 +69,6 @@ static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_IPI_SENT);
 
-	if (ipi_ops->sync)
-		ipi_ops->sync(scratch);
-
 	return 0;
 }
 
@@ -79,6 +76,10 @@ static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
  * As this this function only handlers scalar values of hart mask, it must be
  * set to all online harts if the intention is to send IPIs to all the harts.
  * If hmask is zero, no IPIs will be sent.
+ *
+ * The IPI is raised on all target harts first and the sync callback of the
+ * event is called once afterwards, so the remote harts handle the event in
+ * parallel.
  */
 int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
 {
@@ -86,6 +87,12 @@ int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
 	ulong i, m;
 	struct sbi_domain *dom = sbi_domain_thishart_ptr();
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	const struct sbi_ipi_event_ops *ipi_ops;
+
+	if ((SBI_IPI_EVENT_MAX <= event) ||
+	    !ipi_ops_array[event])
+		return SBI_EINVAL;
+	ipi_ops = ipi_ops_array[event];
 
 	if (hbase != -1UL) {
 		rc = sbi_hsm_hart_interruptible_mask(dom, hbase, &m);
@@ -110,6 +117,9 @@ int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
 		}
 	}
 
+	if (ipi_ops->sync)
+		ipi_ops->sync(scratch);
+
 	return 0;
 }
 
@@ -29,7 +29,7 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 	ulong insn, insn_len;
 	union reg_data val;
 	struct sbi_trap_info uptrap;
-	int i, fp = 0, shift = 0, len = 0;
+	int fp = 0, shift = 0, len = 0;
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_MISALIGNED_LOAD);
 
@@ -70,6 +70,11 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 	} else if ((insn & INSN_MASK_FLW) == INSN_MATCH_FLW) {
 		fp  = 1;
 		len = 4;
+#endif
+#if !defined __riscv_flen && defined SBI_ENABLE_FP_EMULATION
+	} else if ((insn & INSN_MASK_FLH) == INSN_MATCH_FLH) {
+		fp  = 1;
+		len = 2;
 #endif
 	} else if ((insn & INSN_MASK_LH) == INSN_MATCH_LH) {
 		len   = 2;
@@ -121,14 +126,10 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 		return sbi_trap_redirect(regs, &uptrap);
 	}
 
-	val.data_u64 = 0;
-	for (i = 0; i < len; i++) {
-		val.data_bytes[i] = sbi_load_u8((void *)(addr + i),
-						&uptrap);
-		if (uptrap.cause) {
-			uptrap.epc = regs->mepc;
-			return sbi_trap_redirect(regs, &uptrap);
-		}
+	val.data_u64 = sbi_load_misaligned(addr, len, &uptrap);
+	if (uptrap.cause) {
+		uptrap.epc = regs->mepc;
+		return sbi_trap_redirect(regs, &uptrap);
 	}
 
 	if (!fp)
@@ -136,6 +137,10 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 #if defined __riscv_flen || defined SBI_ENABLE_FP_EMULATION
 	else if (len == 8)
 		SET_F64_RD(insn, regs, val.data_u64);
+#if !defined __riscv_flen && defined SBI_ENABLE_FP_EMULATION
+	else if (len == 2)
+		SET_F16_RD(insn, regs, val.data_ulong);
+#endif
 	else
 		SET_F32_RD(insn, regs, val.data_ulong);
 #endif
@@ -151,7 +156,7 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 	ulong insn, insn_len;
 	union reg_data val;
 	struct sbi_trap_info uptrap;
-	int i, len = 0;
+	int len = 0;
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_MISALIGNED_STORE);
 
@@ -175,6 +180,7 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 		insn_len = INSN_LEN(insn);
 	}
 
+	val.data_u64 = 0;
 	val.data_ulong = GET_RS2(insn, regs);
 
 	if ((insn & INSN_MASK_SW) == INSN_MATCH_SW) {
@@ -190,6 +196,11 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 	} else if ((insn & INSN_MASK_FSW) == INSN_MATCH_FSW) {
 		len	       = 4;
 		val.data_ulong = GET_F32_RS2(insn, regs);
+#endif
+#if !defined __riscv_flen && defined SBI_ENABLE_FP_EMULATION
+	} else if ((insn & INSN_MASK_FSH) == INSN_MATCH_FSH) {
+		len	       = 2;
+		val.data_ulong = GET_F32_RS2(insn, regs);
 #endif
 	} else if ((insn & INSN_MASK_SH) == INSN_MATCH_SH) {
 		len = 2;
@@ -234,13 +245,10 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 		return sbi_trap_redirect(regs, &uptrap);
 	}
 
-	for (i = 0; i < len; i++) {
-		sbi_store_u8((void *)(addr + i), val.data_bytes[i],
-			     &uptrap);
-		if (uptrap.cause) {
-			uptrap.epc = regs->mepc;
-			return sbi_trap_redirect(regs, &uptrap);
-		}
+	sbi_store_misaligned(addr, len, val.data_u64, &uptrap);
+	if (uptrap.cause) {
+		uptrap.epc = regs->mepc;
+		return sbi_trap_redirect(regs, &uptrap);
 	}
 
 	regs->mepc += insn_len;
@@ -0,0 +1,98 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_mpsc.h>
+#include <sbi/sbi_string.h>
+
+struct sbi_mpsc_slot {
+	volatile unsigned long seq;
+	unsigned long data[];
+};
+
+static inline struct sbi_mpsc_slot *mpsc_slot(struct sbi_mpsc *mpsc,
+					      unsigned long pos)
+{
+	return mpsc->queue + (pos & (mpsc->num_entries - 1)) *
+			     SBI_MPSC_SLOT_SIZE(mpsc->entry_size);
+}
+
+int sbi_mpsc_init(struct sbi_mpsc *mpsc, void *queue_mem, u16 entries,
+		  u16 entry_size)
+{
+	unsigned long i;
+
+	if (!mpsc || !queue_mem || !entries || (entries & (entries - 1)))
+		return SBI_EINVAL;
+
+	mpsc->queue = queue_mem;
+	mpsc->entry_size = entry_size;
+	mpsc->num_entries = entries;
+	mpsc->head = 0;
+	atomic_write(&mpsc->tail, 0);
+	for (i = 0; i < entries; i++)
+		mpsc_slot(mpsc, i)->seq = i;
+
+	return 0;
+}
+
+int sbi_mpsc_enqueue(struct sbi_mpsc *mpsc, const void *data)
+{
+	struct sbi_mpsc_slot *slot;
+	unsigned long pos, prev;
+	long diff;
+
+	if (!mpsc || !data)
+		return SBI_EINVAL;
+
+	pos = atomic_read(&mpsc->tail);
+	while (1) {
+		slot = mpsc_slot(mpsc, pos);
+		diff = (long)(slot->seq - pos);
+		if (!diff) {
+			/* Slot is free, try to reserve the position */
+			prev = atomic_cmpxchg(&mpsc->tail, pos, pos + 1);
+			if (prev == pos)
+				break;
+			pos = prev;
+		} else if (diff < 0) {
+			/* Slot still holds the entry of the previous lap */
+			return SBI_ENOSPC;
+		} else {
+			/* Another producer took the position */
+			pos = atomic_read(&mpsc->tail);
+		}
+	}
+
+	sbi_memcpy(slot->data, data, mpsc->entry_size);
+	smp_wmb();
+	slot->seq = pos + 1;
+
+	return 0;
+}
+
+int sbi_mpsc_dequeue(struct sbi_mpsc *mpsc, void *data)
+{
+	struct sbi_mpsc_slot *slot;
+
+	if (!mpsc || !data)
+		return SBI_EINVAL;
+
+	/* An entry reserved but not yet written counts as empty */
+	slot = mpsc_slot(mpsc, mpsc->head);
+	if (slot->seq != mpsc->head + 1)
+		return SBI_ENOENT;
+	smp_rmb();
+
+	sbi_memcpy(data, slot->data, mpsc->entry_size);
+	smp_mb();
+	slot->seq = mpsc->head + mpsc->num_entries;
+	mpsc->head++;
+
+	return 0;
+}
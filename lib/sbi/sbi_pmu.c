@@ -15,6 +15,7 @@
 #include <sbi/sbi_pmu.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_string.h>
+#include <sbi/sbi_timer.h>
 
 /** Information about hardware counters */
 struct sbi_pmu_hw_event {
@@ -73,6 +74,23 @@ static uint32_t total_ctrs;
 #define get_cidx_type(x) ((x & SBI_PMU_EVENT_IDX_TYPE_MASK) >> 16)
 #define get_cidx_code(x) (x & SBI_PMU_EVENT_IDX_CODE_MASK)
 
+/**
+ * Get the fw_event_map index of a firmware event code. OpenSBI specific
+ * events are stored right after the standard ones.
+ * @param fw_evt_code Firmware event code
+ *
+ * Return the index, or SBI_PMU_FW_EVENT_MAX for an invalid event code
+ */
+static inline uint32_t pmu_fw_event_index(uint32_t fw_evt_code)
+{
+	if (fw_evt_code < SBI_PMU_FW_MAX)
+		return fw_evt_code;
+	if (fw_evt_code >= SBI_PMU_FW_IMPL_BASE &&
+	    fw_evt_code < SBI_PMU_FW_IMPL_MAX)
+		return SBI_PMU_FW_MAX + fw_evt_code - SBI_PMU_FW_IMPL_BASE;
+	return SBI_PMU_FW_EVENT_MAX;
+}
+
 /**
  * Perform a sanity check on event & counter mappings with event range overlap check
  * @param evtA Pointer to the existing hw event structure
@@ -125,7 +143,7 @@ static int pmu_ctr_read_fw(uint32_t cidx, unsigned long *cval,
 	u32 hartid = current_hartid();
 	struct sbi_pmu_fw_event fevent;
 
-	fevent = fw_event_map[hartid][fw_evt_code];
+	fevent = fw_event_map[hartid][pmu_fw_event_index(fw_evt_code)];
 	*cval = fevent.curr_count;
 
 	return 0;
@@ -316,11 +334,15 @@ static int pmu_ctr_start_fw(uint32_t cidx, uint32_t fw_evt_code,
 	u32 hartid = current_hartid();
 	struct sbi_pmu_fw_event *fevent;
 
-	fevent = &fw_event_map[hartid][fw_evt_code];
+	fevent = &fw_event_map[hartid][pmu_fw_event_index(fw_evt_code)];
 	if (ival_update)
 		fevent->curr_count = ival;
 	fevent->bStarted = TRUE;
 
+	if (fw_evt_code == SBI_PMU_FW_SET_TIMER ||
+	    fw_evt_code == SBI_PMU_FW_ILLEGAL_INSN)
+		sbi_timer_fast_trap_update();
+
 	return 0;
 }
 
@@ -379,7 +401,11 @@ static int pmu_ctr_stop_fw(uint32_t cidx, uint32_t fw_evt_code)
 {
 	u32 hartid = current_hartid();
 
-	fw_event_map[hartid][fw_evt_code].bStarted = FALSE;
+	fw_event_map[hartid][pmu_fw_event_index(fw_evt_code)].bStarted = FALSE;
+
+	if (fw_evt_code == SBI_PMU_FW_SET_TIMER ||
+	    fw_evt_code == SBI_PMU_FW_ILLEGAL_INSN)
+		sbi_timer_fast_trap_update();
 
 	return 0;
 }
@@ -594,6 +620,9 @@ int sbi_pmu_ctr_cfg_match(unsigned long cidx_base, unsigned long cidx_mask,
 	/* Do a basic sanity check of counter base & mask */
 	if (__fls(tmp) >= total_ctrs || event_type >= SBI_PMU_EVENT_TYPE_MAX)
 		return SBI_EINVAL;
+	if (event_type == SBI_PMU_EVENT_TYPE_FW &&
+	    pmu_fw_event_index(get_cidx_code(event_idx)) >= SBI_PMU_FW_EVENT_MAX)
+		return SBI_EINVAL;
 
 	if (flags & SBI_PMU_CFG_FLAG_SKIP_MATCH) {
 		/* The caller wants to skip the match because it already knows the
@@ -626,11 +655,11 @@ skip_match:
 			pmu_ctr_start_hw(ctr_idx, 0, false);
 	} else if (event_type == SBI_PMU_EVENT_TYPE_FW) {
 		fw_evt_code = get_cidx_code(event_idx);
-		fevent = &fw_event_map[hartid][fw_evt_code];
+		fevent = &fw_event_map[hartid][pmu_fw_event_index(fw_evt_code)];
 		if (flags & SBI_PMU_CFG_FLAG_CLEAR_VALUE)
 			fevent->curr_count = 0;
 		if (flags & SBI_PMU_CFG_FLAG_AUTO_START)
-			fevent->bStarted = TRUE;
+			pmu_ctr_start_fw(ctr_idx, fw_evt_code, 0, false);
 	}
 
 	return ctr_idx;
@@ -640,11 +669,12 @@ inline int sbi_pmu_ctr_incr_fw(enum sbi_pmu_fw_event_code_id fw_id)
 {
 	u32 hartid = current_hartid();
 	struct sbi_pmu_fw_event *fevent;
+	uint32_t idx = pmu_fw_event_index(fw_id);
 
-	if (unlikely(fw_id >= SBI_PMU_FW_MAX))
+	if (unlikely(idx >= SBI_PMU_FW_EVENT_MAX))
 		return SBI_EINVAL;
 
-	fevent = &fw_event_map[hartid][fw_id];
+	fevent = &fw_event_map[hartid][idx];
 
 	/* PMU counters will be only enabled during performance debugging */
 	if (unlikely(fevent->bStarted))
@@ -653,6 +683,33 @@ inline int sbi_pmu_ctr_incr_fw(enum sbi_pmu_fw_event_code_id fw_id)
 	return 0;
 }
 
+bool sbi_pmu_fw_event_started(enum sbi_pmu_fw_event_code_id fw_id)
+{
+	uint32_t idx = pmu_fw_event_index(fw_id);
+
+	if (unlikely(idx >= SBI_PMU_FW_EVENT_MAX))
+		return FALSE;
+
+	return fw_event_map[current_hartid()][idx].bStarted;
+}
+
+int sbi_pmu_ctr_add_fw(enum sbi_pmu_fw_event_code_id fw_id, unsigned long val)
+{
+	u32 hartid = current_hartid();
+	struct sbi_pmu_fw_event *fevent;
+	uint32_t idx = pmu_fw_event_index(fw_id);
+
+	if (unlikely(idx >= SBI_PMU_FW_EVENT_MAX))
+		return SBI_EINVAL;
+
+	fevent = &fw_event_map[hartid][idx];
+
+	if (unlikely(fevent->bStarted))
+		fevent->curr_count += val;
+
+	return 0;
+}
+
 unsigned long sbi_pmu_num_ctr(void)
 {
 	return (num_hw_ctrs + SBI_PMU_FW_CTR_MAX);
@@ -695,9 +752,12 @@ static void pmu_reset_event_map(u32 hartid)
 	/* Initialize the counter to event mapping table */
 	for (j = 3; j < total_ctrs; j++)
 		active_events[hartid][j] = SBI_PMU_EVENT_IDX_INVALID;
-	for (j = 0; j < SBI_PMU_FW_CTR_MAX; j++)
+	for (j = 0; j < SBI_PMU_FW_EVENT_MAX; j++)
 		sbi_memset(&fw_event_map[hartid][j], 0,
 			   sizeof(struct sbi_pmu_fw_event));
+
+	/* SET_TIMER and ILLEGAL_INSN are stopped now */
+	sbi_timer_fast_trap_update();
 }
 
 void sbi_pmu_exit(struct sbi_scratch *scratch)
@@ -10,6 +10,7 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/sbi_bitops.h>
+#include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_hsm.h>
@@ -81,6 +82,9 @@ void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason)
 	/* Stop current HART */
 	sbi_hsm_hart_stop(scratch, FALSE);
 
+	/* Write out buffered console output before the system goes away */
+	sbi_console_flush();
+
 	/* Platform specific reset if domain allowed system reset */
 	if (dom->system_reset_allowed) {
 		const struct sbi_system_reset_device *dev =
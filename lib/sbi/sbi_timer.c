@@ -19,6 +19,7 @@
 #include <sbi/sbi_timer.h>
 
 static unsigned long time_delta_off;
+static unsigned long time_fast_off;
 static u64 (*get_time_val)(void);
 static const struct sbi_timer_device *timer_dev = NULL;
 
@@ -136,6 +137,46 @@ void sbi_timer_process(void)
 	csr_set(CSR_MIP, MIP_STIP);
 }
 
+struct timer_fast_mmio {
+	unsigned long mtime_addr;
+	unsigned long mtimecmp_addr;
+};
+
+void sbi_timer_set_fast_mmio(unsigned long mtime_addr,
+			     unsigned long mtimecmp_addr)
+{
+	struct timer_fast_mmio *fm;
+
+	if (!time_fast_off)
+		return;
+
+	fm = sbi_scratch_thishart_offset_ptr(time_fast_off);
+	fm->mtime_addr = mtime_addr;
+	fm->mtimecmp_addr = mtimecmp_addr;
+	sbi_timer_fast_trap_update();
+}
+
+void sbi_timer_fast_trap_update(void)
+{
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	struct timer_fast_mmio *fm;
+
+	if (!time_fast_off)
+		return;
+
+	/* The fast trap path does not update PMU firmware counters */
+	if (sbi_pmu_fw_event_started(SBI_PMU_FW_SET_TIMER) ||
+	    sbi_pmu_fw_event_started(SBI_PMU_FW_ILLEGAL_INSN)) {
+		scratch->mtime_addr = 0;
+		scratch->mtimecmp_addr = 0;
+		return;
+	}
+
+	fm = sbi_scratch_offset_ptr(scratch, time_fast_off);
+	scratch->mtime_addr = fm->mtime_addr;
+	scratch->mtimecmp_addr = fm->mtimecmp_addr;
+}
+
 const struct sbi_timer_device *sbi_timer_get_device(void)
 {
 	return timer_dev;
@@ -161,15 +202,21 @@ int sbi_timer_init(struct sbi_scratch *scratch, bool cold_boot)
 		if (!time_delta_off)
 			return SBI_ENOMEM;
 
+		time_fast_off = sbi_scratch_alloc_offset(
+					sizeof(struct timer_fast_mmio));
+		if (!time_fast_off)
+			return SBI_ENOMEM;
+
 		if (sbi_hart_has_feature(scratch, SBI_HART_HAS_TIME))
 			get_time_val = get_ticks;
 	} else {
-		if (!time_delta_off)
+		if (!time_delta_off || !time_fast_off)
 			return SBI_ENOMEM;
 	}
 
 	time_delta = sbi_scratch_offset_ptr(scratch, time_delta_off);
 	*time_delta = 0;
+	sbi_timer_set_fast_mmio(0, 0);
 
 	return sbi_platform_timer_init(plat, cold_boot);
 }
@@ -179,6 +226,7 @@ void sbi_timer_exit(struct sbi_scratch *scratch)
 	if (timer_dev && timer_dev->timer_event_stop)
 		timer_dev->timer_event_stop();
 
+	sbi_timer_set_fast_mmio(0, 0);
 	csr_clear(CSR_MIP, MIP_STIP);
 	csr_clear(CSR_MIE, MIP_MTIP);
 
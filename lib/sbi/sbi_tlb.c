@@ -12,9 +12,9 @@
 #include <sbi/riscv_atomic.h>
 #include <sbi/riscv_barrier.h>
 #include <sbi/sbi_error.h>
-#include <sbi/sbi_fifo.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_ipi.h>
+#include <sbi/sbi_mpsc.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_tlb.h>
 #include <sbi/sbi_hfence.h>
@@ -23,16 +23,88 @@
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_pmu.h>
 
-static unsigned long tlb_sync_off;
-static unsigned long tlb_fifo_off;
-static unsigned long tlb_fifo_mem_off;
+/*
+ * Shootdown descriptor of the TLB request a HART is waiting for. It lives
+ * in the sender's scratch space and remote HARTs only get a pointer to it
+ * in their queue.
+ */
+struct tlb_desc {
+	/* Remote HARTs which have not finished the request yet */
+	atomic_t pending;
+	struct sbi_tlb_info info;
+};
+
+static unsigned long tlb_desc_off;
+/*
+ * Queue of requests for a HART. Senders which find the queue full mark
+ * themselves in the overflow mask instead of waiting for a free slot.
+ */
+struct tlb_queue {
+	struct sbi_mpsc mpsc;
+	struct sbi_hartmask overflow;
+};
+
+static unsigned long tlb_queue_off;
+static unsigned long tlb_queue_mem_off;
 static unsigned long tlb_range_flush_limit;
+static bool tlb_range_flush_calibrated;
 
 static void tlb_flush_all(void)
 {
 	__asm__ __volatile("sfence.vma");
 }
 
+#define TLB_CALIBRATE_PAGES		64
+#define TLB_CALIBRATE_ROUNDS		8
+#define TLB_CALIBRATE_MAX_PAGES		512
+
+/*
+ * Time a full SFENCE.VMA against TLB_CALIBRATE_PAGES single-page ones with
+ * MCYCLE and return the range size for which both cost the same. Only the
+ * fence itself is measured, not the refills it causes later, so this is a
+ * lower bound of the real crossover.
+ */
+static unsigned long tlb_calibrate_range_flush_limit(void)
+{
+	unsigned long i, r, t, pages;
+	unsigned long t_all = -1UL, t_range = -1UL;
+
+	for (r = 0; r < TLB_CALIBRATE_ROUNDS; r++) {
+		t = csr_read(CSR_MCYCLE);
+		tlb_flush_all();
+		t = csr_read(CSR_MCYCLE) - t;
+		if (t < t_all)
+			t_all = t;
+
+		t = csr_read(CSR_MCYCLE);
+		for (i = 0; i < TLB_CALIBRATE_PAGES; i++)
+			__asm__ __volatile__("sfence.vma %0"
+					     : : "r"(i * PAGE_SIZE) : "memory");
+		t = csr_read(CSR_MCYCLE) - t;
+		if (t < t_range)
+			t_range = t;
+	}
+
+	/* MCYCLE not running, keep the single page default */
+	if (!t_all || !t_range)
+		return PAGE_SIZE;
+
+	pages = t_all * TLB_CALIBRATE_PAGES / t_range;
+	if (pages < 1)
+		pages = 1;
+	else if (pages > TLB_CALIBRATE_MAX_PAGES)
+		pages = TLB_CALIBRATE_MAX_PAGES;
+
+	return pages * PAGE_SIZE;
+}
+
+unsigned long sbi_tlb_range_flush_limit(bool *calibrated)
+{
+	if (calibrated)
+		*calibrated = tlb_range_flush_calibrated;
+	return tlb_range_flush_limit;
+}
+
 void sbi_tlb_local_hfence_vvma(struct sbi_tlb_info *tinfo)
 {
 	unsigned long start = tinfo->start;
@@ -211,180 +283,272 @@ static void tlb_pmu_incr_fw_ctr(struct sbi_tlb_info *data)
 		sbi_pmu_ctr_incr_fw(SBI_PMU_FW_HFENCE_VVMA_ASID_SENT);
 }
 
-static void tlb_entry_process(struct sbi_tlb_info *tinfo)
+/*
+ * Requests of one family can be merged. Within the SFENCE.VMA, HFENCE.GVMA
+ * and HFENCE.VVMA families, the ASID or VMID scoped variant covers less
+ * than the global one.
+ */
+enum tlb_family {
+	TLB_FAMILY_NONE,
+	TLB_FAMILY_FENCE_I,
+	TLB_FAMILY_SFENCE_VMA,
+	TLB_FAMILY_HFENCE_GVMA,
+	TLB_FAMILY_HFENCE_VVMA,
+};
+
+static int tlb_family(const struct sbi_tlb_info *tinfo)
 {
-	u32 rhartid;
-	struct sbi_scratch *rscratch = NULL;
-	unsigned long *rtlb_sync = NULL;
+	if (tinfo->local_fn == sbi_tlb_local_fence_i)
+		return TLB_FAMILY_FENCE_I;
+	if (tinfo->local_fn == sbi_tlb_local_sfence_vma ||
+	    tinfo->local_fn == sbi_tlb_local_sfence_vma_asid)
+		return TLB_FAMILY_SFENCE_VMA;
+	if (tinfo->local_fn == sbi_tlb_local_hfence_gvma ||
+	    tinfo->local_fn == sbi_tlb_local_hfence_gvma_vmid)
+		return TLB_FAMILY_HFENCE_GVMA;
+	if (tinfo->local_fn == sbi_tlb_local_hfence_vvma ||
+	    tinfo->local_fn == sbi_tlb_local_hfence_vvma_asid)
+		return TLB_FAMILY_HFENCE_VVMA;
+	return TLB_FAMILY_NONE;
+}
 
-	tinfo->local_fn(tinfo);
+static bool tlb_is_scoped(const struct sbi_tlb_info *tinfo)
+{
+	return tinfo->local_fn == sbi_tlb_local_sfence_vma_asid ||
+	       tinfo->local_fn == sbi_tlb_local_hfence_gvma_vmid ||
+	       tinfo->local_fn == sbi_tlb_local_hfence_vvma_asid;
+}
 
-	sbi_hartmask_for_each_hart(rhartid, &tinfo->smask) {
-		rscratch = sbi_hartid_to_scratch(rhartid);
-		if (!rscratch)
-			continue;
+/* The ASID or VMID a scoped request is limited to */
+static unsigned long tlb_scope(const struct sbi_tlb_info *tinfo)
+{
+	if (tinfo->local_fn == sbi_tlb_local_hfence_gvma_vmid)
+		return tinfo->vmid;
+	return tinfo->asid;
+}
 
-		rtlb_sync = sbi_scratch_offset_ptr(rscratch, tlb_sync_off);
-		while (atomic_raw_xchg_ulong(rtlb_sync, 1)) ;
-	}
+/*
+ * Does the request flush the whole family? Scoped variants do so for a
+ * zero start and size, while a size of SBI_TLB_FLUSH_ALL only flushes
+ * their ASID or VMID.
+ */
+static bool tlb_is_global_all(const struct sbi_tlb_info *tinfo)
+{
+	if (tinfo->start == 0 && tinfo->size == 0)
+		return TRUE;
+	return !tlb_is_scoped(tinfo) && tinfo->size == SBI_TLB_FLUSH_ALL;
+}
+
+static bool tlb_is_ranged(const struct sbi_tlb_info *tinfo)
+{
+	return !tlb_is_global_all(tinfo) &&
+	       tinfo->size != SBI_TLB_FLUSH_ALL &&
+	       tinfo->start + tinfo->size >= tinfo->start;
 }
 
-static void tlb_process_count(struct sbi_scratch *scratch, int count)
+/*
+ * Try to merge request b into request a, widening a if needed. Returns
+ * the firmware event counting the merge, or SBI_PMU_FW_MAX if b has to
+ * be performed separately.
+ */
+static int tlb_coalesce(struct sbi_tlb_info *a, const struct sbi_tlb_info *b)
 {
-	struct sbi_tlb_info tinfo;
-	unsigned int deq_count = 0;
-	struct sbi_fifo *tlb_fifo =
-			sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
+	int family = tlb_family(a);
+	unsigned long start, end;
+
+	if (family == TLB_FAMILY_NONE || family != tlb_family(b))
+		return SBI_PMU_FW_MAX;
+	if (family == TLB_FAMILY_FENCE_I)
+		return SBI_PMU_FW_RFENCE_MERGE_FENCE_I;
+	/* HFENCE.VVMA requests act on the VMID of their sender */
+	if (family == TLB_FAMILY_HFENCE_VVMA && a->vmid != b->vmid)
+		return SBI_PMU_FW_MAX;
+
+	if (tlb_is_global_all(a))
+		return SBI_PMU_FW_RFENCE_MERGE_ALL;
+	if (tlb_is_global_all(b)) {
+		*a = *b;
+		return SBI_PMU_FW_RFENCE_MERGE_ALL;
+	}
 
-	while (!sbi_fifo_dequeue(tlb_fifo, &tinfo)) {
-		tlb_entry_process(&tinfo);
-		deq_count++;
-		if (deq_count > count)
-			break;
+	if (a->local_fn != b->local_fn) {
+		/* A global range absorbs the same range of any scope */
+		if (!tlb_is_ranged(a) || !tlb_is_ranged(b))
+			return SBI_PMU_FW_MAX;
+		if (tlb_is_scoped(b) && a->start <= b->start &&
+		    b->start + b->size <= a->start + a->size)
+			return SBI_PMU_FW_RFENCE_MERGE_GLOBAL;
+		if (tlb_is_scoped(a) && b->start <= a->start &&
+		    a->start + a->size <= b->start + b->size) {
+			*a = *b;
+			return SBI_PMU_FW_RFENCE_MERGE_GLOBAL;
+		}
+		return SBI_PMU_FW_MAX;
+	}
+
+	if (tlb_is_scoped(a) && tlb_scope(a) != tlb_scope(b))
+		return SBI_PMU_FW_MAX;
 
+	/* Flush of a whole ASID or VMID */
+	if (a->size == SBI_TLB_FLUSH_ALL)
+		return SBI_PMU_FW_RFENCE_MERGE_ALL;
+	if (b->size == SBI_TLB_FLUSH_ALL) {
+		*a = *b;
+		return SBI_PMU_FW_RFENCE_MERGE_ALL;
 	}
-}
 
-static void tlb_process(struct sbi_scratch *scratch)
-{
-	struct sbi_tlb_info tinfo;
-	struct sbi_fifo *tlb_fifo =
-			sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
+	/* Overlapping or adjacent ranges */
+	if (!tlb_is_ranged(a) || !tlb_is_ranged(b) ||
+	    b->start > a->start + a->size || a->start > b->start + b->size)
+		return SBI_PMU_FW_MAX;
+
+	start = (a->start < b->start) ? a->start : b->start;
+	end = (a->start + a->size > b->start + b->size) ?
+	      a->start + a->size : b->start + b->size;
+	if (end - start > tlb_range_flush_limit) {
+		a->start = 0;
+		a->size = SBI_TLB_FLUSH_ALL;
+	} else {
+		a->start = start;
+		a->size = end - start;
+	}
 
-	while (!sbi_fifo_dequeue(tlb_fifo, &tinfo))
-		tlb_entry_process(&tinfo);
+	return SBI_PMU_FW_RFENCE_MERGE_RANGE;
 }
 
-static void tlb_sync(struct sbi_scratch *scratch)
+/*
+ * Perform a batch of requests dequeued together. Requests are merged
+ * into working copies first, as the descriptors are shared with other
+ * harts. Every request is acknowledged, whether it was merged or not.
+ */
+static void tlb_batch_process(struct tlb_desc **batch, int count)
 {
-	unsigned long *tlb_sync =
-			sbi_scratch_offset_ptr(scratch, tlb_sync_off);
+	int i, j, event;
+	bool merged[SBI_TLB_FIFO_NUM_ENTRIES];
+	struct sbi_tlb_info work[SBI_TLB_FIFO_NUM_ENTRIES];
 
-	while (!atomic_raw_xchg_ulong(tlb_sync, 0)) {
-		/*
-		 * While we are waiting for remote hart to set the sync,
-		 * consume fifo requests to avoid deadlock.
-		 */
-		tlb_process_count(scratch, 1);
+	for (i = 0; i < count; i++) {
+		work[i] = batch[i]->info;
+		merged[i] = FALSE;
 	}
 
-	return;
+	for (i = 0; i < count; i++) {
+		if (merged[i])
+			continue;
+		for (j = i + 1; j < count; j++) {
+			if (merged[j])
+				continue;
+			event = tlb_coalesce(&work[i], &work[j]);
+			if (event == SBI_PMU_FW_MAX)
+				continue;
+			sbi_pmu_ctr_incr_fw(event);
+			merged[j] = TRUE;
+			/* A wider request may now absorb skipped ones */
+			j = i;
+		}
+		work[i].local_fn(&work[i]);
+	}
+
+	for (i = 0; i < count; i++)
+		atomic_sub_return(&batch[i]->pending, 1);
 }
 
-static inline int tlb_range_check(struct sbi_tlb_info *curr,
-					struct sbi_tlb_info *next)
+/* Perform the requests of senders which found the queue full */
+static int tlb_overflow_process(struct tlb_queue *tlb_q)
 {
-	unsigned long curr_end;
-	unsigned long next_end;
-	int ret = SBI_FIFO_UNCHANGED;
-
-	if (!curr || !next)
-		return ret;
-
-	next_end = next->start + next->size;
-	curr_end = curr->start + curr->size;
-	if (next->start <= curr->start && next_end > curr_end) {
-		curr->start = next->start;
-		curr->size  = next->size;
-		sbi_hartmask_or(&curr->smask, &curr->smask, &next->smask);
-		ret = SBI_FIFO_UPDATED;
-	} else if (next->start >= curr->start && next_end <= curr_end) {
-		sbi_hartmask_or(&curr->smask, &curr->smask, &next->smask);
-		ret = SBI_FIFO_SKIP;
+	int n = 0;
+	u32 i, hartid;
+	unsigned long bits;
+	struct sbi_scratch *rscratch;
+	struct tlb_desc *desc;
+	unsigned long *ovf = sbi_hartmask_bits(&tlb_q->overflow);
+
+	for (i = 0; i < BITS_TO_LONGS(SBI_HARTMASK_MAX_BITS); i++) {
+		if (!ovf[i])
+			continue;
+		bits = atomic_raw_xchg_ulong(&ovf[i], 0);
+		for (hartid = i * BITS_PER_LONG; bits; hartid++, bits >>= 1) {
+			if (!(bits & 1UL))
+				continue;
+			rscratch = sbi_hartid_to_scratch(hartid);
+			if (!rscratch)
+				continue;
+			desc = sbi_scratch_offset_ptr(rscratch, tlb_desc_off);
+			desc->info.local_fn(&desc->info);
+			atomic_sub_return(&desc->pending, 1);
+			n++;
+		}
 	}
 
-	return ret;
+	return n;
 }
 
-/**
- * Call back to decide if an inplace fifo update is required or next entry can
- * can be skipped. Here are the different cases that are being handled.
- *
- * Case1:
- *	if next flush request range lies within one of the existing entry, skip
- *	the next entry.
- * Case2:
- *	if flush request range in current fifo entry lies within next flush
- *	request, update the current entry.
- *
- * Note:
- *	We can not issue a fifo reset anymore if a complete vma flush is requested.
- *	This is because we are queueing FENCE.I requests as well now.
- *	To ease up the pressure in enqueue/fifo sync path, try to dequeue 1 element
- *	before continuing the while loop. This method is preferred over wfi/ipi because
- *	of MMIO cost involved in later method.
- */
-static int tlb_update_cb(void *in, void *data)
+static int tlb_process_count(struct sbi_scratch *scratch, int count)
 {
-	struct sbi_tlb_info *curr;
-	struct sbi_tlb_info *next;
-	int ret = SBI_FIFO_UNCHANGED;
-
-	if (!in || !data)
-		return ret;
-
-	curr = (struct sbi_tlb_info *)data;
-	next = (struct sbi_tlb_info *)in;
-
-	if (next->local_fn == sbi_tlb_local_sfence_vma_asid &&
-	    curr->local_fn == sbi_tlb_local_sfence_vma_asid) {
-		if (next->asid == curr->asid)
-			ret = tlb_range_check(curr, next);
-	} else if (next->local_fn == sbi_tlb_local_sfence_vma &&
-		   curr->local_fn == sbi_tlb_local_sfence_vma) {
-		ret = tlb_range_check(curr, next);
-	}
+	int done, n = 0;
+	struct tlb_desc *batch[SBI_TLB_FIFO_NUM_ENTRIES];
+	struct tlb_queue *tlb_q =
+			sbi_scratch_offset_ptr(scratch, tlb_queue_off);
+
+	done = tlb_overflow_process(tlb_q);
+	if (done >= count)
+		return done;
 
-	return ret;
+	while (n < count - done &&
+	       !sbi_mpsc_dequeue(&tlb_q->mpsc, &batch[n]))
+		n++;
+	tlb_batch_process(batch, n);
+
+	return done + n;
+}
+
+static void tlb_process(struct sbi_scratch *scratch)
+{
+	while (tlb_process_count(scratch, SBI_TLB_FIFO_NUM_ENTRIES))
+		;
+}
+
+static void tlb_sync(struct sbi_scratch *scratch)
+{
+	struct tlb_desc *desc = sbi_scratch_offset_ptr(scratch, tlb_desc_off);
+
+	while (atomic_read(&desc->pending)) {
+		/*
+		 * While we are waiting for remote harts to finish,
+		 * consume queued requests to avoid deadlock.
+		 */
+		tlb_process_count(scratch, 1);
+	}
 }
 
 static int tlb_update(struct sbi_scratch *scratch,
 			  struct sbi_scratch *remote_scratch,
 			  u32 remote_hartid, void *data)
 {
-	int ret;
-	struct sbi_fifo *tlb_fifo_r;
-	struct sbi_tlb_info *tinfo = data;
+	struct tlb_queue *tlb_q_r;
+	struct tlb_desc *desc = data;
 	u32 curr_hartid = current_hartid();
 
-	/*
-	 * If address range to flush is too big then simply
-	 * upgrade it to flush all because we can only flush
-	 * 4KB at a time.
-	 */
-	if (tinfo->size > tlb_range_flush_limit) {
-		tinfo->start = 0;
-		tinfo->size = SBI_TLB_FLUSH_ALL;
-	}
-
 	/*
 	 * If the request is to queue a tlb flush entry for itself
 	 * then just do a local flush and return;
 	 */
 	if (remote_hartid == curr_hartid) {
-		tinfo->local_fn(tinfo);
+		desc->info.local_fn(&desc->info);
 		return -1;
 	}
 
-	tlb_fifo_r = sbi_scratch_offset_ptr(remote_scratch, tlb_fifo_off);
-
-	ret = sbi_fifo_inplace_update(tlb_fifo_r, data, tlb_update_cb);
-	if (ret != SBI_FIFO_UNCHANGED) {
-		return 1;
-	}
+	tlb_q_r = sbi_scratch_offset_ptr(remote_scratch, tlb_queue_off);
 
-	while (sbi_fifo_enqueue(tlb_fifo_r, data) < 0) {
-		/**
-		 * For now, Busy loop until there is space in the fifo.
-		 * There may be case where target hart is also
-		 * enqueue in source hart's fifo. Both hart may busy
-		 * loop leading to a deadlock.
-		 * TODO: Introduce a wait/wakeup event mechanism to handle
-		 * this properly.
+	atomic_add_return(&desc->pending, 1);
+	if (sbi_mpsc_enqueue(&tlb_q_r->mpsc, &desc)) {
+		/*
+		 * The remote hart finds our descriptor through the
+		 * overflow mask, as the descriptor stays valid until
+		 * the request is done.
 		 */
-		tlb_process_count(scratch, 1);
-		sbi_dprintf("hart%d: hart%d tlb fifo full\n",
-			    curr_hartid, remote_hartid);
+		atomic_raw_set_bit(curr_hartid,
+				   sbi_hartmask_bits(&tlb_q_r->overflow));
 	}
 
 	return 0;
@@ -401,64 +565,90 @@ static u32 tlb_event = SBI_IPI_EVENT_MAX;
 
 int sbi_tlb_request(ulong hmask, ulong hbase, struct sbi_tlb_info *tinfo)
 {
+	struct tlb_desc *desc;
+
 	if (!tinfo->local_fn)
 		return SBI_EINVAL;
 
 	tlb_pmu_incr_fw_ctr(tinfo);
 
-	return sbi_ipi_send_many(hmask, hbase, tlb_event, tinfo);
+	/* Requests are synchronous, so the descriptor is free again */
+	desc = sbi_scratch_offset_ptr(sbi_scratch_thishart_ptr(),
+				      tlb_desc_off);
+	desc->info = *tinfo;
+
+	/*
+	 * If address range to flush is too big then simply
+	 * upgrade it to flush all because we can only flush
+	 * 4KB at a time.
+	 */
+	if (desc->info.size > tlb_range_flush_limit) {
+		desc->info.start = 0;
+		desc->info.size = SBI_TLB_FLUSH_ALL;
+	}
+
+	return sbi_ipi_send_many(hmask, hbase, tlb_event, desc);
 }
 
 int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 {
 	int ret;
+	u64 limit;
 	void *tlb_mem;
-	unsigned long *tlb_sync;
-	struct sbi_fifo *tlb_q;
+	struct tlb_desc *desc;
+	struct tlb_queue *tlb_q;
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 
 	if (cold_boot) {
-		tlb_sync_off = sbi_scratch_alloc_offset(sizeof(*tlb_sync));
-		if (!tlb_sync_off)
+		tlb_desc_off = sbi_scratch_alloc_offset(sizeof(*desc));
+		if (!tlb_desc_off)
 			return SBI_ENOMEM;
-		tlb_fifo_off = sbi_scratch_alloc_offset(sizeof(*tlb_q));
-		if (!tlb_fifo_off) {
-			sbi_scratch_free_offset(tlb_sync_off);
+		tlb_queue_off = sbi_scratch_alloc_offset(sizeof(*tlb_q));
+		if (!tlb_queue_off) {
+			sbi_scratch_free_offset(tlb_desc_off);
 			return SBI_ENOMEM;
 		}
-		tlb_fifo_mem_off = sbi_scratch_alloc_offset(
-				SBI_TLB_FIFO_NUM_ENTRIES * SBI_TLB_INFO_SIZE);
-		if (!tlb_fifo_mem_off) {
-			sbi_scratch_free_offset(tlb_fifo_off);
-			sbi_scratch_free_offset(tlb_sync_off);
+		tlb_queue_mem_off = sbi_scratch_alloc_offset(
+				SBI_TLB_FIFO_NUM_ENTRIES *
+				SBI_MPSC_SLOT_SIZE(sizeof(desc)));
+		if (!tlb_queue_mem_off) {
+			sbi_scratch_free_offset(tlb_queue_off);
+			sbi_scratch_free_offset(tlb_desc_off);
 			return SBI_ENOMEM;
 		}
 		ret = sbi_ipi_event_create(&tlb_ops);
 		if (ret < 0) {
-			sbi_scratch_free_offset(tlb_fifo_mem_off);
-			sbi_scratch_free_offset(tlb_fifo_off);
-			sbi_scratch_free_offset(tlb_sync_off);
+			sbi_scratch_free_offset(tlb_queue_mem_off);
+			sbi_scratch_free_offset(tlb_queue_off);
+			sbi_scratch_free_offset(tlb_desc_off);
 			return ret;
 		}
 		tlb_event = ret;
-		tlb_range_flush_limit = sbi_platform_tlbr_flush_limit(plat);
+		limit = sbi_platform_tlbr_flush_limit(plat);
+		if (limit == SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_AUTO) {
+			tlb_range_flush_limit =
+				tlb_calibrate_range_flush_limit();
+			tlb_range_flush_calibrated = TRUE;
+		} else {
+			tlb_range_flush_limit = limit;
+		}
 	} else {
-		if (!tlb_sync_off ||
-		    !tlb_fifo_off ||
-		    !tlb_fifo_mem_off)
+		if (!tlb_desc_off ||
+		    !tlb_queue_off ||
+		    !tlb_queue_mem_off)
 			return SBI_ENOMEM;
 		if (SBI_IPI_EVENT_MAX <= tlb_event)
 			return SBI_ENOSPC;
 	}
 
-	tlb_sync = sbi_scratch_offset_ptr(scratch, tlb_sync_off);
-	tlb_q = sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
-	tlb_mem = sbi_scratch_offset_ptr(scratch, tlb_fifo_mem_off);
+	desc = sbi_scratch_offset_ptr(scratch, tlb_desc_off);
+	tlb_q = sbi_scratch_offset_ptr(scratch, tlb_queue_off);
+	tlb_mem = sbi_scratch_offset_ptr(scratch, tlb_queue_mem_off);
 
-	*tlb_sync = 0;
+	atomic_write(&desc->pending, 0);
 
-	sbi_fifo_init(tlb_q, tlb_mem,
-		      SBI_TLB_FIFO_NUM_ENTRIES, SBI_TLB_INFO_SIZE);
+	SBI_HARTMASK_INIT(&tlb_q->overflow);
 
-	return 0;
+	return sbi_mpsc_init(&tlb_q->mpsc, tlb_mem,
+			     SBI_TLB_FIFO_NUM_ENTRIES, sizeof(desc));
 }
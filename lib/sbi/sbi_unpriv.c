@@ -114,6 +114,162 @@ void sbi_store_u64(u64 *addr, u64 val,
 }
 #endif
 
+/*
+ * Load up to sizeof(ulong) bytes with at most two naturally aligned
+ * loads in one MPRV window. The trap handler clobbers a4, which is used
+ * to skip the second load after a fault.
+ */
+static ulong unpriv_load_chunk(ulong addr, ulong len,
+			       struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3");
+	register ulong ttmp asm("a4") = 0;
+	register ulong mstatus = 0;
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+	ulong base = addr & ~(sizeof(ulong) - 1);
+	ulong shift = (addr - base) * 8;
+	ulong two = (addr - base + len > sizeof(ulong));
+	ulong lo = 0, hi = 0, ret;
+
+	trap->cause = 0;
+
+	asm volatile(
+	    "add %[tinfo], %[taddr], zero\n"
+	    "csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+	    "csrrs %[mstatus], " STR(CSR_MSTATUS) ", %[mprv]\n"
+	    ".option push\n"
+	    ".option norvc\n"
+	    REG_L " %[lo], 0(%[base])\n"
+	    "bnez %[ttmp], 1f\n"
+	    "beqz %[two], 1f\n"
+	    REG_L " %[hi], " SZREG "(%[base])\n"
+	    ".option pop\n"
+	    "1: csrw " STR(CSR_MSTATUS) ", %[mstatus]\n"
+	    "csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mstatus] "+&r"(mstatus), [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp),
+	      [lo] "+&r"(lo), [hi] "+&r"(hi)
+	    : [mprv] "r"(MSTATUS_MPRV), [taddr] "r"((ulong)trap),
+	      [base] "r"(base), [two] "r"(two)
+	    : "memory");
+
+	ret = lo >> shift;
+	if (two)
+		ret |= hi << (8 * sizeof(ulong) - shift);
+	if (len < sizeof(ulong))
+		ret &= (1UL << (8 * len)) - 1;
+
+	return ret;
+}
+
+/*
+ * Store up to sizeof(ulong) bytes in naturally aligned pieces of at most
+ * four bytes in one MPRV window. Each piece lies within one page and PMP
+ * region so a fault is reported for the first byte which is not stored.
+ */
+static void unpriv_store_chunk(ulong addr, ulong len, ulong val,
+			       struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3");
+	register ulong ttmp asm("a4") = 0;
+	register ulong mstatus = 0;
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+	ulong tmp;
+
+	trap->cause = 0;
+
+	asm volatile(
+	    "add %[tinfo], %[taddr], zero\n"
+	    "csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+	    "csrrs %[mstatus], " STR(CSR_MSTATUS) ", %[mprv]\n"
+	    ".option push\n"
+	    ".option norvc\n"
+	    "2: andi %[tmp], %[addr], 1\n"
+	    "bnez %[tmp], 4f\n"
+	    "li %[tmp], 2\n"
+	    "bltu %[len], %[tmp], 4f\n"
+#if __riscv_xlen == 64
+	    "andi %[tmp], %[addr], 3\n"
+	    "bnez %[tmp], 3f\n"
+	    "li %[tmp], 4\n"
+	    "bltu %[len], %[tmp], 3f\n"
+	    "sw %[val], 0(%[addr])\n"
+	    "srli %[val], %[val], 32\n"
+	    "addi %[addr], %[addr], 4\n"
+	    "addi %[len], %[len], -4\n"
+	    "j 5f\n"
+#endif
+	    "3: sh %[val], 0(%[addr])\n"
+	    "srli %[val], %[val], 16\n"
+	    "addi %[addr], %[addr], 2\n"
+	    "addi %[len], %[len], -2\n"
+	    "j 5f\n"
+	    "4: sb %[val], 0(%[addr])\n"
+	    "srli %[val], %[val], 8\n"
+	    "addi %[addr], %[addr], 1\n"
+	    "addi %[len], %[len], -1\n"
+	    "5: bnez %[ttmp], 1f\n"
+	    "bnez %[len], 2b\n"
+	    ".option pop\n"
+	    "1: csrw " STR(CSR_MSTATUS) ", %[mstatus]\n"
+	    "csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mstatus] "+&r"(mstatus), [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp),
+	      [addr] "+&r"(addr), [len] "+&r"(len), [val] "+&r"(val),
+	      [tmp] "=&r"(tmp)
+	    : [mprv] "r"(MSTATUS_MPRV), [taddr] "r"((ulong)trap)
+	    : "memory");
+}
+
+u64 sbi_load_misaligned(ulong addr, ulong len, struct sbi_trap_info *trap)
+{
+	u64 ret;
+	ulong i;
+
+#if __riscv_xlen == 32
+	if (len > sizeof(ulong)) {
+		ret = unpriv_load_chunk(addr, sizeof(ulong), trap);
+		if (!trap->cause)
+			ret |= (u64)unpriv_load_chunk(addr + sizeof(ulong),
+						      len - sizeof(ulong),
+						      trap) << 32;
+	} else
+#endif
+		ret = unpriv_load_chunk(addr, len, trap);
+	if (!trap->cause)
+		return ret;
+
+	/*
+	 * The aligned loads may cover bytes outside of [addr, addr + len)
+	 * so repeat byte by byte to report the fault precisely.
+	 */
+	ret = 0;
+	for (i = 0; i < len; i++) {
+		ret |= (u64)sbi_load_u8((const u8 *)(addr + i), trap) << (8 * i);
+		if (trap->cause)
+			return 0;
+	}
+
+	return ret;
+}
+
+void sbi_store_misaligned(ulong addr, ulong len, u64 val,
+			  struct sbi_trap_info *trap)
+{
+#if __riscv_xlen == 32
+	if (len > sizeof(ulong)) {
+		unpriv_store_chunk(addr, sizeof(ulong), val, trap);
+		if (!trap->cause)
+			unpriv_store_chunk(addr + sizeof(ulong),
+					   len - sizeof(ulong), val >> 32,
+					   trap);
+		return;
+	}
+#endif
+
+	unpriv_store_chunk(addr, len, val, trap);
+}
+
 ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
 {
 	register ulong tinfo asm("a3");
@@ -18,6 +18,143 @@
 #include <sbi_utils/fdt/fdt_pmu.h>
 #include <sbi_utils/fdt/fdt_helper.h>
 
+#if defined(SBI_ENABLE_FP_EMULATION) && !defined(__riscv_flen)
+/* Extensions emulated by OpenSBI on top of the (emulated) F extension */
+#define FDT_CPU_EMULATED_EXT		"zfh"
+#define FDT_CPU_EMULATED_EXT_LEN	(sizeof(FDT_CPU_EMULATED_EXT) - 1)
+
+static bool fdt_isa_has_ext(const char *isa, int len, const char *ext)
+{
+	const char *p = sbi_strchr(isa, '_');
+	int ext_len = sbi_strlen(ext);
+
+	while (p && p < isa + len) {
+		p++;
+		if (!sbi_strncmp(p, ext, ext_len) &&
+		    (p[ext_len] == '_' || p[ext_len] == '\0'))
+			return true;
+		p = sbi_strchr(p, '_');
+	}
+
+	return false;
+}
+
+/*
+ * Property values are padded to 4 bytes, so growing a property by len
+ * bytes grows the FDT by at most len + 3 bytes.
+ */
+#define FDT_PROP_GROWTH(len)		((len) + 3)
+
+/*
+ * The fixup helpers below apply their change when apply is true and
+ * return 0 or a negative libfdt error. Otherwise they only return how
+ * many bytes the change would grow the FDT by.
+ */
+static int fdt_cpu_isa_ext_fixup(void *fdt, int cpu_offset, const char *ext,
+				 bool apply)
+{
+	const char *prop;
+	int len;
+
+	prop = fdt_getprop(fdt, cpu_offset, "riscv,isa-extensions", &len);
+	if (!prop || fdt_stringlist_contains(prop, len, ext))
+		return 0;
+	if (!apply)
+		return FDT_PROP_GROWTH(sbi_strlen(ext) + 1);
+
+	return fdt_appendprop_string(fdt, cpu_offset, "riscv,isa-extensions",
+				     ext);
+}
+
+static int fdt_cpu_isa_fixup(void *fdt, int cpu_offset, bool apply)
+{
+	int i, len, rc, old_len, ret = 0, has_f = 0;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	int d_pos = 0, has_q = 0;
+#endif
+	bool changed = false;
+	const char *prop;
+	char isa[128];
+
+	prop = fdt_getprop(fdt, cpu_offset, "riscv,isa", &len);
+	/* Room for "q", "_" and the emulated extensions */
+	if (!prop || len < 5 ||
+	    len + FDT_CPU_EMULATED_EXT_LEN + 2 > sizeof(isa))
+		return 0;
+	sbi_strncpy(isa, prop, len);
+	isa[len - 1] = '\0';
+	old_len = len;
+
+	/* Only advertise the extensions on top of F (or G) */
+	for (i = 4; isa[i] && isa[i] != '_'; i++) {
+		if (isa[i] == 'f' || isa[i] == 'g')
+			has_f = 1;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+		if (isa[i] == 'd' || isa[i] == 'g')
+			d_pos = i;
+		if (isa[i] == 'q')
+			has_q = 1;
+#endif
+	}
+	if (!has_f)
+		return 0;
+
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	/* Q goes right after D in the canonical order */
+	if (d_pos && !has_q) {
+		sbi_memmove(&isa[d_pos + 2], &isa[d_pos + 1], len - d_pos - 1);
+		isa[d_pos + 1] = 'q';
+		len++;
+		changed = true;
+		rc = fdt_cpu_isa_ext_fixup(fdt, cpu_offset, "q", apply);
+		if (rc < 0)
+			return rc;
+		ret += rc;
+	}
+#endif
+
+	if (!fdt_isa_has_ext(isa, len, FDT_CPU_EMULATED_EXT)) {
+		isa[len - 1] = '_';
+		sbi_memcpy(&isa[len], FDT_CPU_EMULATED_EXT,
+			   sizeof(FDT_CPU_EMULATED_EXT));
+		len += FDT_CPU_EMULATED_EXT_LEN + 1;
+		changed = true;
+		rc = fdt_cpu_isa_ext_fixup(fdt, cpu_offset,
+					   FDT_CPU_EMULATED_EXT, apply);
+		if (rc < 0)
+			return rc;
+		ret += rc;
+	}
+
+	if (!changed)
+		return ret;
+	if (!apply)
+		return ret + FDT_PROP_GROWTH(len - old_len);
+
+	return fdt_setprop_string(fdt, cpu_offset, "riscv,isa", isa);
+}
+
+static int fdt_cpu_isa_fixup_space(void *fdt, int cpus_offset)
+{
+	int cpu_offset, space = 0;
+
+	fdt_for_each_subnode(cpu_offset, fdt, cpus_offset)
+		space += fdt_cpu_isa_fixup(fdt, cpu_offset, false);
+
+	return space;
+}
+#else
+static int fdt_cpu_isa_fixup(void *fdt, int cpu_offset, bool apply)
+{
+	return 0;
+}
+
+static int fdt_cpu_isa_fixup_space(void *fdt, int cpus_offset)
+{
+	return 0;
+}
+#endif
+
 void fdt_cpu_fixup(void *fdt)
 {
 	struct sbi_domain *dom = sbi_domain_thishart_ptr();
@@ -25,7 +162,12 @@ void fdt_cpu_fixup(void *fdt)
 	const char *mmu_type;
 	u32 hartid;
 
-	err = fdt_open_into(fdt, fdt, fdt_totalsize(fdt) + 32);
+	cpus_offset = fdt_path_offset(fdt, "/cpus");
+	if (cpus_offset < 0)
+		return;
+
+	err = fdt_open_into(fdt, fdt, fdt_totalsize(fdt) + 32 +
+			    fdt_cpu_isa_fixup_space(fdt, cpus_offset));
 	if (err < 0)
 		return;
 
@@ -49,6 +191,12 @@ void fdt_cpu_fixup(void *fdt)
 		    !mmu_type || !len)
 			fdt_setprop_string(fdt, cpu_offset, "status",
 					   "disabled");
+
+		err = fdt_cpu_isa_fixup(fdt, cpu_offset, true);
+		if (err)
+			sbi_printf("%s: %s riscv,isa fixup failed, %d\n",
+				   __func__, fdt_get_name(fdt, cpu_offset, NULL),
+				   err);
 	}
 }
 
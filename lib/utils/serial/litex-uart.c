@@ -40,6 +40,22 @@ static void litex_uart_putc(char ch)
 	set_reg(UART_REG_RXTX, ch);
 }
 
+static void litex_uart_puts(const char *str, size_t len)
+{
+	size_t i;
+
+	/* The UART only reports a full FIFO, so fill it up to that point */
+	for (i = 0; i < len; i++) {
+		while (get_reg(UART_REG_TXFULL));
+		set_reg(UART_REG_RXTX, str[i]);
+	}
+}
+
+static unsigned long litex_uart_tx_room(void)
+{
+	return get_reg(UART_REG_TXFULL) ? 0 : 1;
+}
+
 static int litex_uart_getc(void)
 {
 	if (get_reg(UART_REG_RXEMPTY))
@@ -51,6 +67,8 @@ static int litex_uart_getc(void)
 static struct sbi_console_device litex_console = {
 	.name = "litex_uart",
 	.console_putc = litex_uart_putc,
+	.console_puts = litex_uart_puts,
+	.console_tx_room = litex_uart_tx_room,
 	.console_getc = litex_uart_getc
 };
 
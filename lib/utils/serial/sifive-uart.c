@@ -25,7 +25,11 @@
 #define UART_RXFIFO_EMPTY	0x80000000
 #define UART_RXFIFO_DATA	0x000000ff
 #define UART_TXCTRL_TXEN	0x1
+#define UART_TXCTRL_TXCNT_SHIFT	16
 #define UART_RXCTRL_RXEN	0x1
+#define UART_IP_TXWM		0x1
+
+#define UART_TXFIFO_DEPTH	8
 
 /* clang-format on */
 
@@ -74,6 +78,30 @@ static void sifive_uart_putc(char ch)
 	set_reg(UART_REG_TXFIFO, ch);
 }
 
+static void sifive_uart_puts(const char *str, size_t len)
+{
+	size_t i, burst;
+
+	while (len) {
+		/* TXWM is pending while the FIFO holds less than txcnt = 1 */
+		while (!(get_reg(UART_REG_IP) & UART_IP_TXWM))
+			;
+
+		burst = (len < UART_TXFIFO_DEPTH) ? len : UART_TXFIFO_DEPTH;
+		for (i = 0; i < burst; i++)
+			set_reg(UART_REG_TXFIFO, str[i]);
+		str += burst;
+		len -= burst;
+	}
+}
+
+static unsigned long sifive_uart_tx_room(void)
+{
+	if (get_reg(UART_REG_IP) & UART_IP_TXWM)
+		return UART_TXFIFO_DEPTH;
+	return 0;
+}
+
 static int sifive_uart_getc(void)
 {
 	u32 ret = get_reg(UART_REG_RXFIFO);
@@ -85,6 +113,8 @@ static int sifive_uart_getc(void)
 static struct sbi_console_device sifive_console = {
 	.name = "sifive_uart",
 	.console_putc = sifive_uart_putc,
+	.console_puts = sifive_uart_puts,
+	.console_tx_room = sifive_uart_tx_room,
 	.console_getc = sifive_uart_getc
 };
 
@@ -99,8 +129,9 @@ int sifive_uart_init(unsigned long base, u32 in_freq, u32 baudrate)
 		set_reg(UART_REG_DIV, uart_min_clk_divisor(in_freq, baudrate));
 	/* Disable interrupts */
 	set_reg(UART_REG_IE, 0);
-	/* Enable TX */
-	set_reg(UART_REG_TXCTRL, UART_TXCTRL_TXEN);
+	/* Enable TX, with the watermark signalling an empty FIFO */
+	set_reg(UART_REG_TXCTRL,
+		UART_TXCTRL_TXEN | (1 << UART_TXCTRL_TXCNT_SHIFT));
 	/* Enable Rx */
 	set_reg(UART_REG_RXCTRL, UART_RXCTRL_RXEN);
 
@@ -37,6 +37,9 @@
 #define UART_LSR_DR		0x01	/* Receiver data ready */
 #define UART_LSR_BRK_ERROR_BITS	0x1E	/* BI, FE, PE, OE bits */
 
+#define UART_IIR_FIFO_ENABLED	0xC0	/* 16550A FIFOs enabled */
+#define UART_FIFO_DEPTH		16	/* 16550A transmit FIFO */
+
 /* clang-format on */
 
 static volatile void *uart8250_base;
@@ -44,6 +47,7 @@ static u32 uart8250_in_freq;
 static u32 uart8250_baudrate;
 static u32 uart8250_reg_width;
 static u32 uart8250_reg_shift;
+static u32 uart8250_tx_depth;
 
 static u32 get_reg(u32 num)
 {
@@ -77,6 +81,30 @@ static void uart8250_putc(char ch)
 	set_reg(UART_THR_OFFSET, ch);
 }
 
+static void uart8250_puts(const char *str, size_t len)
+{
+	size_t i, burst;
+
+	while (len) {
+		/* With FIFOs enabled, THRE means the whole FIFO is empty */
+		while ((get_reg(UART_LSR_OFFSET) & UART_LSR_THRE) == 0)
+			;
+
+		burst = (len < uart8250_tx_depth) ? len : uart8250_tx_depth;
+		for (i = 0; i < burst; i++)
+			set_reg(UART_THR_OFFSET, str[i]);
+		str += burst;
+		len -= burst;
+	}
+}
+
+static unsigned long uart8250_tx_room(void)
+{
+	if (get_reg(UART_LSR_OFFSET) & UART_LSR_THRE)
+		return uart8250_tx_depth;
+	return 0;
+}
+
 static int uart8250_getc(void)
 {
 	if (get_reg(UART_LSR_OFFSET) & UART_LSR_DR)
@@ -87,6 +115,8 @@ static int uart8250_getc(void)
 static struct sbi_console_device uart8250_console = {
 	.name = "uart8250",
 	.console_putc = uart8250_putc,
+	.console_puts = uart8250_puts,
+	.console_tx_room = uart8250_tx_room,
 	.console_getc = uart8250_getc
 };
 
@@ -119,6 +149,12 @@ int uart8250_init(unsigned long base, u32 in_freq, u32 baudrate, u32 reg_shift,
 	set_reg(UART_LCR_OFFSET, 0x03);
 	/* Enable FIFO */
 	set_reg(UART_FCR_OFFSET, 0x01);
+	/* Plain 8250/16450 have no FIFO, so send one byte per THRE */
+	if ((get_reg(UART_IIR_OFFSET) & UART_IIR_FIFO_ENABLED) ==
+	    UART_IIR_FIFO_ENABLED)
+		uart8250_tx_depth = UART_FIFO_DEPTH;
+	else
+		uart8250_tx_depth = 1;
 	/* No modem control DTR RTS */
 	set_reg(UART_MCR_OFFSET, 0x00);
 	/* Clear line status */
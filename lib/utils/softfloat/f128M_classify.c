@@ -0,0 +1,39 @@
+// See LICENSE for license details.
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sbi_utils/softfloat/platform.h"
+#include "sbi_utils/softfloat/internals.h"
+#include "sbi_utils/softfloat/specialize.h"
+#include "sbi_utils/softfloat/softfloat.h"
+
+uint_fast16_t f128M_classify( const float128_t *aPtr )
+{
+    const uint32_t *aWPtr;
+    uint32_t uiA96;
+
+    aWPtr = (const uint32_t *) aPtr;
+    uiA96 = aWPtr[indexWordHi( 4 )];
+
+    uint_fast16_t infOrNaN = expF128UI96( uiA96 ) == 0x7FFF;
+    uint_fast16_t subnormalOrZero = expF128UI96( uiA96 ) == 0;
+    bool sign = signF128UI96( uiA96 );
+    bool fracZero =
+        ! (fracF128UI96( uiA96 ) | aWPtr[indexWord( 4, 2 )]
+               | aWPtr[indexWord( 4, 1 )] | aWPtr[indexWord( 4, 0 )]);
+    bool isNaN = infOrNaN && ! fracZero;
+    bool isSigNaN = isNaN && f128M_isSignalingNaN( aPtr );
+
+    return
+        (  sign && infOrNaN && fracZero )          << 0 |
+        (  sign && !infOrNaN && !subnormalOrZero ) << 1 |
+        (  sign && subnormalOrZero && !fracZero )  << 2 |
+        (  sign && subnormalOrZero && fracZero )   << 3 |
+        ( !sign && infOrNaN && fracZero )          << 7 |
+        ( !sign && !infOrNaN && !subnormalOrZero ) << 6 |
+        ( !sign && subnormalOrZero && !fracZero )  << 5 |
+        ( !sign && subnormalOrZero && fracZero )   << 4 |
+        ( isNaN &&  isSigNaN )                     << 8 |
+        ( isNaN && !isSigNaN )                     << 9;
+}
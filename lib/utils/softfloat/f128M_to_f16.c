@@ -59,7 +59,7 @@ float16_t f128M_to_f16( const float128_t *aPtr )
     bool sign;
     int32_t exp;
     uint32_t frac32;
-    struct commonNaN commonNaN;
+    // struct commonNaN commonNaN;
     uint16_t uiZ, frac16;
     union ui16_f16 uZ;
 
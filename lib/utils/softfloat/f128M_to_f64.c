@@ -59,7 +59,7 @@ float64_t f128M_to_f64( const float128_t *aPtr )
     bool sign;
     int32_t exp;
     uint64_t frac64;
-    struct commonNaN commonNaN;
+    // struct commonNaN commonNaN;
     uint64_t uiZ;
     uint32_t frac32;
     union ui64_f64 uZ;
@@ -0,0 +1,35 @@
+// See LICENSE for license details.
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sbi_utils/softfloat/platform.h"
+#include "sbi_utils/softfloat/internals.h"
+#include "sbi_utils/softfloat/specialize.h"
+#include "sbi_utils/softfloat/softfloat.h"
+
+uint_fast16_t f16_classify( float16_t a )
+{
+    union ui16_f16 uA;
+    uint_fast16_t uiA;
+
+    uA.f = a;
+    uiA = uA.ui;
+
+    uint_fast16_t infOrNaN = expF16UI( uiA ) == 0x1F;
+    uint_fast16_t subnormalOrZero = expF16UI( uiA ) == 0;
+    bool sign = signF16UI( uiA );
+
+    return
+        (  sign && infOrNaN && fracF16UI( uiA ) == 0 )          << 0 |
+        (  sign && !infOrNaN && !subnormalOrZero )              << 1 |
+        (  sign && subnormalOrZero && fracF16UI( uiA ) )        << 2 |
+        (  sign && subnormalOrZero && fracF16UI( uiA ) == 0 )   << 3 |
+        ( !sign && infOrNaN && fracF16UI( uiA ) == 0 )          << 7 |
+        ( !sign && !infOrNaN && !subnormalOrZero )              << 6 |
+        ( !sign && subnormalOrZero && fracF16UI( uiA ) )        << 5 |
+        ( !sign && subnormalOrZero && fracF16UI( uiA ) == 0 )   << 4 |
+        ( isNaNF16UI( uiA ) &&  softfloat_isSigNaNF16UI( uiA )) << 8 |
+        ( isNaNF16UI( uiA ) && !softfloat_isSigNaNF16UI( uiA )) << 9;
+}
+
@@ -139,6 +139,7 @@ libsbiutils-objs-y += softfloat/s_addCarryM.o
 libsbiutils-objs-y += softfloat/extF80M_to_ui64.o
 libsbiutils-objs-y += softfloat/s_subMagsF16.o
 libsbiutils-objs-y += softfloat/s_remStepMBy32.o
+libsbiutils-objs-y += softfloat/f16_classify.o
 libsbiutils-objs-y += softfloat/f32_classify.o
 libsbiutils-objs-y += softfloat/s_lt128.o
 libsbiutils-objs-y += softfloat/i32_to_extF80M.o
@@ -173,7 +174,10 @@ libsbiutils-objs-y += softfloat/s_normRoundPackMToF128M.o
 libsbiutils-objs-y += softfloat/f128M_add.o
 libsbiutils-objs-y += softfloat/f128M_le_quiet.o
 libsbiutils-objs-y += softfloat/f128M_sub.o
+libsbiutils-objs-y += softfloat/f128M_classify.o
+libsbiutils-objs-y += softfloat/f128M_to_f16.o
 libsbiutils-objs-y += softfloat/f128M_to_f32.o
+libsbiutils-objs-y += softfloat/f128M_to_f64.o
 libsbiutils-objs-y += softfloat/extF80_to_i32.o
 libsbiutils-objs-y += softfloat/f16_to_i32.o
 libsbiutils-objs-y += softfloat/f16_to_extF80M.o
@@ -248,3 +252,5 @@ libsbiutils-objs-y += softfloat/f64_div.o
 libsbiutils-objs-y += softfloat/f16_mul.o
 libsbiutils-objs-y += softfloat/extF80M_lt_quiet.o
 libsbiutils-objs-y += softfloat/s_normSubnormalF32Sig.o
+libsbiutils-objs-y += softfloat/s_roundPackToF16.o
+libsbiutils-objs-y += softfloat/s_roundPackMToF128M.o
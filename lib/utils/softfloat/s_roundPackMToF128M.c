@@ -160,7 +160,9 @@ void
             }
         }
     } else {
+#ifdef SOFTFLOAT_ROUND_ODD
  noIncrementPackReturn:
+#endif
         zWPtr[indexWord( 4, 0 )] = uj;
         ui = extSigPtr[indexWord( 5, 2 )];
         zWPtr[indexWord( 4, 1 )] = ui;
@@ -40,10 +40,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "sbi_utils/softfloat/internals.h"
 #include "sbi_utils/softfloat/softfloat.h"
 
-float16_t
- softfloat_roundPackToF16( bool sign, int_fast16_t exp, uint_fast16_t sig )
+static inline __attribute__((always_inline)) float16_t
+ roundPackToF16(
+     bool sign, int_fast16_t exp, uint_fast16_t sig, uint_fast8_t roundingMode )
 {
-    uint_fast8_t roundingMode;
     bool roundNearEven;
     uint_fast8_t roundIncrement, roundBits;
     bool isTiny;
@@ -52,7 +52,6 @@ float16_t
 
     /*------------------------------------------------------------------------
     *------------------------------------------------------------------------*/
-    roundingMode = softfloat_roundingMode;
     roundNearEven = (roundingMode == softfloat_round_near_even);
     roundIncrement = 0x8;
     if ( ! roundNearEven && (roundingMode != softfloat_round_near_maxMag) ) {
@@ -103,7 +102,10 @@ float16_t
     if ( ! sig ) exp = 0;
     /*------------------------------------------------------------------------
     *------------------------------------------------------------------------*/
+
+#ifdef SOFTFLOAT_ROUND_ODD
  packReturn:
+#endif
     uiZ = packToF16UI( sign, exp, sig );
  uiZ:
     uZ.ui = uiZ;
@@ -111,3 +113,14 @@ float16_t
 
 }
 
+float16_t
+ softfloat_roundPackToF16( bool sign, int_fast16_t exp, uint_fast16_t sig )
+{
+    uint_fast8_t roundingMode = softfloat_roundingMode;
+
+    if ( roundingMode == softfloat_round_near_even ) {
+        return roundPackToF16( sign, exp, sig, softfloat_round_near_even );
+    }
+    return roundPackToF16( sign, exp, sig, roundingMode );
+
+}
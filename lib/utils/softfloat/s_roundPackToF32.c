@@ -40,10 +40,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "sbi_utils/softfloat/internals.h"
 #include "sbi_utils/softfloat/softfloat.h"
 
-float32_t
- softfloat_roundPackToF32( bool sign, int_fast16_t exp, uint_fast32_t sig )
+static inline __attribute__((always_inline)) float32_t
+ roundPackToF32(
+     bool sign, int_fast16_t exp, uint_fast32_t sig, uint_fast8_t roundingMode )
 {
-    uint_fast8_t roundingMode;
     bool roundNearEven;
     uint_fast8_t roundIncrement, roundBits;
     bool isTiny;
@@ -52,7 +52,6 @@ float32_t
 
     /*------------------------------------------------------------------------
     *------------------------------------------------------------------------*/
-    roundingMode = softfloat_roundingMode;
     roundNearEven = (roundingMode == softfloat_round_near_even);
     roundIncrement = 0x40;
     if ( ! roundNearEven && (roundingMode != softfloat_round_near_maxMag) ) {
@@ -114,3 +113,18 @@ float32_t
 
 }
 
+/*----------------------------------------------------------------------------
+| Round-to-nearest-even gets an instance of its own in which all tests of the
+| rounding mode fold away. Other modes share a generic instance.
+*----------------------------------------------------------------------------*/
+float32_t
+ softfloat_roundPackToF32( bool sign, int_fast16_t exp, uint_fast32_t sig )
+{
+    uint_fast8_t roundingMode = softfloat_roundingMode;
+
+    if ( roundingMode == softfloat_round_near_even ) {
+        return roundPackToF32( sign, exp, sig, softfloat_round_near_even );
+    }
+    return roundPackToF32( sign, exp, sig, roundingMode );
+
+}
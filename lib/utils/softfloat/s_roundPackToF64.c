@@ -40,10 +40,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "sbi_utils/softfloat/internals.h"
 #include "sbi_utils/softfloat/softfloat.h"
 
-float64_t
- softfloat_roundPackToF64( bool sign, int_fast16_t exp, uint_fast64_t sig )
+static inline __attribute__((always_inline)) float64_t
+ roundPackToF64(
+     bool sign, int_fast16_t exp, uint_fast64_t sig, uint_fast8_t roundingMode )
 {
-    uint_fast8_t roundingMode;
     bool roundNearEven;
     uint_fast16_t roundIncrement, roundBits;
     bool isTiny;
@@ -52,7 +52,6 @@ float64_t
 
     /*------------------------------------------------------------------------
     *------------------------------------------------------------------------*/
-    roundingMode = softfloat_roundingMode;
     roundNearEven = (roundingMode == softfloat_round_near_even);
     roundIncrement = 0x200;
     if ( ! roundNearEven && (roundingMode != softfloat_round_near_maxMag) ) {
@@ -118,3 +117,14 @@ float64_t
 
 }
 
+float64_t
+ softfloat_roundPackToF64( bool sign, int_fast16_t exp, uint_fast64_t sig )
+{
+    uint_fast8_t roundingMode = softfloat_roundingMode;
+
+    if ( roundingMode == softfloat_round_near_even ) {
+        return roundPackToF64( sign, exp, sig, softfloat_round_near_even );
+    }
+    return roundPackToF64( sign, exp, sig, roundingMode );
+
+}
@@ -139,6 +139,13 @@ int aclint_mtimer_warm_init(void)
 	mt->time_wr(true, -1ULL,
 		    &mt_time_cmp[target_hart - mt->first_hartid]);
 
+#if __riscv_xlen != 32
+	/* Let the trap vector access MTIMER directly */
+	if (mt->has_64bit_mmio)
+		sbi_timer_set_fast_mmio(mt->mtime_addr,
+			(unsigned long)&mt_time_cmp[target_hart - mt->first_hartid]);
+#endif
+
 	return 0;
 }
 
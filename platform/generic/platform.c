@@ -177,6 +177,19 @@ static int generic_domains_init(void)
 
 static u64 generic_tlbr_flush_limit(void)
 {
+	int chosen_offset, len;
+	const fdt32_t *val;
+	void *fdt = fdt_get_address();
+
+	/* The DT can override both the platform value and calibration */
+	chosen_offset = fdt_path_offset(fdt, "/chosen");
+	if (chosen_offset >= 0) {
+		val = fdt_getprop(fdt, chosen_offset,
+				  "opensbi,tlb-range-flush-limit", &len);
+		if (val && len >= sizeof(fdt32_t))
+			return fdt32_to_cpu(*val);
+	}
+
 	if (generic_plat && generic_plat->tlbr_flush_limit)
 		return generic_plat->tlbr_flush_limit(generic_plat_match);
 	return SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT;
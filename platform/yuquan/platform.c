@@ -17,6 +17,7 @@
 #include <libfdt.h>
 #include <sbi_utils/ipi/aclint_mswi.h>
 #include <sbi_utils/irqchip/plic.h>
+#include <sbi_utils/fdt/fdt_fixup.h>
 #include <sbi_utils/fdt/fdt_helper.h>
 #include <sbi_utils/irqchip/fdt_irqchip.h>
 #include <sbi_utils/serial/fdt_serial.h>
@@ -79,6 +80,9 @@ static int yuquan_early_init(bool cold_boot)
 
 static int yuquan_final_init(bool cold_boot)
 {
+	if (cold_boot)
+		fdt_cpu_fixup(fdt_get_address());
+
 	return 0;
 }
 
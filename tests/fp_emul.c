@@ -0,0 +1,889 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+/*
+ * Conformance test and benchmark of the FP emulation against the host FPU.
+ *
+ * Every S and D add/sub/mul/div/sqrt is emulated for random operands in
+ * each static rounding mode and compared with the result and accrued
+ * flags of the host. NaN results are compared as the canonical NaN, as
+ * RISC-V does not propagate payloads.
+ *
+ * Zfh is checked against the host _Float16: FCVT between H and S/D and
+ * between H and integers in every rounding mode, FCLASS.H, FLH/FSH and
+ * the NaN-boxing of H results and operands.
+ *
+ * Built with SBI_ENABLE_FP_EMULATION_Q, as fp_emul_q, it also checks Q
+ * add/sub/mul/div and conversions between Q and S/D/integers against the
+ * host __float128, and FLQ/FSQ round trips.
+ *
+ * Usage: fp_emul [-b] [cases]
+ */
+
+#include <fenv.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_fp_emulation.h>
+#include <sbi/sbi_illegal_insn.h>
+#include <sbi/sbi_trap.h>
+#include <sbi_utils/softfloat/softfloat.h>
+#include "fp_test.h"
+#include "sbi_host.h"
+
+static union {
+	struct sbi_trap_regs regs;
+	u8 bytes[SBI_TRAP_REGS_SIZE];
+} frame;
+
+#define FREG(n)	(((u64 *)&frame.bytes[SBI_TRAP_REGS_OFFSET(last)])[n])
+
+enum { OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_SQRT, OP_MAX };
+
+static const char *op_name[OP_MAX] = {
+	"fadd", "fsub", "fmul", "fdiv", "fsqrt"
+};
+static const u32 op_funct5[OP_MAX] = { 0x00, 0x01, 0x02, 0x03, 0x0B };
+static const int host_rm[4] = {
+	FE_TONEAREST, FE_TOWARDZERO, FE_DOWNWARD, FE_UPWARD
+};
+
+/* <op>.<s|d> f3, f1, f2 with the given rounding mode */
+static u32 make_insn(int op, int dp, int rm)
+{
+	return (op_funct5[op] << 27) | (dp << 25) |
+	       ((op == OP_SQRT) ? 0 : (2 << 20)) | (1 << 15) | (rm << 12) |
+	       (3 << 7) | 0x53;
+}
+
+static void emulate(u32 insn)
+{
+	frame.regs.mepc = 0;
+	fp_opcode_exec(fp_opcode_decode(insn), insn, &frame.regs);
+}
+
+static int host_flags(void)
+{
+	int flags = 0;
+
+	if (fetestexcept(FE_INVALID))
+		flags |= softfloat_flag_invalid;
+	if (fetestexcept(FE_DIVBYZERO))
+		flags |= softfloat_flag_infinite;
+	if (fetestexcept(FE_OVERFLOW))
+		flags |= softfloat_flag_overflow;
+	if (fetestexcept(FE_UNDERFLOW))
+		flags |= softfloat_flag_underflow;
+	if (fetestexcept(FE_INEXACT))
+		flags |= softfloat_flag_inexact;
+
+	return flags;
+}
+
+static u64 host_f64(int op, u64 a, u64 b)
+{
+	volatile double x, y, z;
+	u64 r;
+
+	memcpy((void *)&x, &a, sizeof(a));
+	memcpy((void *)&y, &b, sizeof(b));
+	switch (op) {
+	case OP_ADD:
+		z = x + y;
+		break;
+	case OP_SUB:
+		z = x - y;
+		break;
+	case OP_MUL:
+		z = x * y;
+		break;
+	case OP_DIV:
+		z = x / y;
+		break;
+	default:
+		z = sqrt(x);
+		break;
+	}
+	memcpy(&r, (void *)&z, sizeof(r));
+
+	return ((r << 1) > 0xFFE0000000000000ULL) ? 0x7FF8000000000000ULL : r;
+}
+
+static u32 host_f32(int op, u32 a, u32 b)
+{
+	volatile float x, y, z;
+	u32 r;
+
+	memcpy((void *)&x, &a, sizeof(a));
+	memcpy((void *)&y, &b, sizeof(b));
+	switch (op) {
+	case OP_ADD:
+		z = x + y;
+		break;
+	case OP_SUB:
+		z = x - y;
+		break;
+	case OP_MUL:
+		z = x * y;
+		break;
+	case OP_DIV:
+		z = x / y;
+		break;
+	default:
+		z = sqrtf(x);
+		break;
+	}
+	memcpy(&r, (void *)&z, sizeof(r));
+
+	return ((u32)(r << 1) > 0xFF000000U) ? 0x7FC00000 : r;
+}
+
+static long conformance(long cases)
+{
+	int dp, op, rm, emu_flags, ref_flags;
+	u64 a, b, res, ref;
+	long i, bad = 0;
+
+	for (dp = 0; dp < 2; dp++)
+	for (op = 0; op < OP_MAX; op++)
+	for (rm = 0; rm < 4; rm++) {
+		u32 insn = make_insn(op, dp, rm);
+
+		for (i = 0; i < cases; i++) {
+			if (dp) {
+				a = fp_test_rand_f64();
+				b = fp_test_rand_f64();
+			} else {
+				a = fp_test_rand_f32() | 0xFFFFFFFF00000000ULL;
+				b = fp_test_rand_f32() | 0xFFFFFFFF00000000ULL;
+			}
+			FREG(1) = a;
+			FREG(2) = b;
+			tp = 0;
+			emulate(insn);
+			res = FREG(3);
+			emu_flags = tp & 0x1F;
+
+			fesetround(host_rm[rm]);
+			feclearexcept(FE_ALL_EXCEPT);
+			if (dp)
+				ref = host_f64(op, a, b);
+			else
+				ref = host_f32(op, a, b) | 0xFFFFFFFF00000000ULL;
+			ref_flags = host_flags();
+			fesetround(FE_TONEAREST);
+
+			/*
+			 * x86 detects tininess before rounding and RISC-V
+			 * after rounding, so underflow may differ.
+			 */
+			emu_flags &= ~softfloat_flag_underflow;
+			ref_flags &= ~softfloat_flag_underflow;
+			if (res == ref && emu_flags == ref_flags)
+				continue;
+			if (bad++ < 10)
+				printf("%s.%c rm=%d %016llx %016llx: "
+				       "%016llx/%02x expected %016llx/%02x\n",
+				       op_name[op], dp ? 'd' : 's', rm,
+				       (unsigned long long)a,
+				       (unsigned long long)b,
+				       (unsigned long long)res, emu_flags,
+				       (unsigned long long)ref, ref_flags);
+		}
+	}
+
+	printf("fp_emul: %ld cases, %ld mismatches\n", 2 * OP_MAX * 4 * cases,
+	       bad);
+	return bad;
+}
+
+#define F16_BOX		0xFFFFFFFFFFFF0000ULL
+#define F16_CANON_NAN	0x7E00
+
+/* fcvt.h.<s|d|w|wu|l|lu> and back, rd and rs1 are f3/x3 and f1/x1 */
+#define INSN_FCVT_H(src, rm)	((0x22U << 25) | ((src) << 20) | \
+				 (1 << 15) | ((rm) << 12) | (3 << 7) | 0x53)
+#define INSN_FCVT_FROM_H(dp)	((((dp) ? 0x21U : 0x20U) << 25) | \
+				 (2 << 20) | (1 << 15) | (3 << 7) | 0x53)
+#define INSN_FCVT_H_INT(src, rm) ((0x6AU << 25) | ((src) << 20) | \
+				 (1 << 15) | ((rm) << 12) | (3 << 7) | 0x53)
+#define INSN_FCVT_INT_H(dst, rm) ((0x62U << 25) | ((dst) << 20) | \
+				 (1 << 15) | ((rm) << 12) | (3 << 7) | 0x53)
+#define INSN_FCLASS_H		((0x72U << 25) | (1 << 15) | (1 << 12) | \
+				 (3 << 7) | 0x53)
+#define INSN_FLH		((1 << 15) | (1 << 12) | (3 << 7) | 0x07)
+#define INSN_FSH		((2 << 20) | (1 << 15) | (1 << 12) | 0x27)
+
+static long zfh_cases, zfh_bad;
+
+static void zfh_check(const char *name, int rm, u64 a, u64 res, int emu_flags,
+		      u64 ref, int ref_flags)
+{
+	zfh_cases++;
+	/* Tininess detection differs between x86 and RISC-V, see above */
+	emu_flags &= ~softfloat_flag_underflow;
+	ref_flags &= ~softfloat_flag_underflow;
+	if (res == ref && emu_flags == ref_flags)
+		return;
+	if (zfh_bad++ < 10)
+		printf("%s rm=%d %016llx: %016llx/%02x expected %016llx/%02x\n",
+		       name, rm, (unsigned long long)a,
+		       (unsigned long long)res, emu_flags,
+		       (unsigned long long)ref, ref_flags);
+}
+
+static u16 host_h(volatile _Float16 h)
+{
+	u16 r;
+
+	memcpy(&r, (void *)&h, sizeof(r));
+
+	return ((r & 0x7FFF) > 0x7C00) ? F16_CANON_NAN : r;
+}
+
+static double host_h_to_double(u16 a)
+{
+	_Float16 h;
+
+	memcpy(&h, &a, sizeof(h));
+
+	return h;
+}
+
+/* A random integer, often within or just beyond the range of f16 */
+static u64 rand_int(void)
+{
+	u64 r = fp_test_rand(), e = fp_test_rand();
+
+	switch (e & 3) {
+	case 0:
+		return (s64)(s32)r % 70000;
+	case 1:
+		return (s64)r >> (e >> 2) % 64;
+	default:
+		return r;
+	}
+}
+
+/*
+ * Round an f16 value to an integer in the given RISC-V rounding mode.
+ * Every finite f16 is an exact multiple of 2^-24 below 2^16, so this is
+ * done on the scaled integer rather than with rint(), which the compiler
+ * may inline without regard to the rounding mode.
+ */
+static double round_h(double d, int rm)
+{
+	s64 v = d * 0x1p24, q = v >> 24, rem = v & 0xFFFFFF;
+
+	switch (rm) {
+	case 0:
+		if (rem > 0x800000 || (rem == 0x800000 && (q & 1)))
+			q++;
+		break;
+	case 1:
+		if (rem && v < 0)
+			q++;
+		break;
+	case 3:
+		if (rem)
+			q++;
+		break;
+	}
+
+	return q;
+}
+
+/* fcvt.<w|wu|l|lu>.h as specified: round, then saturate on overflow */
+static u64 ref_fcvt_int_h(int dst, int rm, u16 a, int *flags)
+{
+	static const double lo[4] = { -0x1p31, 0, -0x1p63, 0 };
+	static const double hi[4] = { 0x1p31, 0x1p32, 0x1p63, 0x1p64 };
+	static const u64 min[4] = { 0xFFFFFFFF80000000ULL, 0,
+				    0x8000000000000000ULL, 0 };
+	static const u64 max[4] = { 0x7FFFFFFF, 0xFFFFFFFFFFFFFFFFULL,
+				    0x7FFFFFFFFFFFFFFFULL,
+				    0xFFFFFFFFFFFFFFFFULL };
+	double d = host_h_to_double(a), r;
+
+	*flags = 0;
+	if (isnan(d)) {
+		*flags = softfloat_flag_invalid;
+		return max[dst];
+	}
+	r = isinf(d) ? d : round_h(d, rm);
+	if (r < lo[dst] || r >= hi[dst]) {
+		*flags = softfloat_flag_invalid;
+		return (r < 0) ? min[dst] : max[dst];
+	}
+	if (r != d)
+		*flags = softfloat_flag_inexact;
+	if (dst == 1)
+		return (s64)(s32)(u32)r;
+
+	return (dst == 0) ? (u64)(s64)r : (u64)r;
+}
+
+static u64 ref_fclass_h(u16 a)
+{
+	double d = host_h_to_double(a);
+	int neg = signbit(d);
+
+	switch (fpclassify(d)) {
+	case FP_INFINITE:
+		return neg ? 1 << 0 : 1 << 7;
+	case FP_NORMAL:
+		/* f16 subnormals are normal once widened */
+		if (!(a & 0x7C00))
+			return neg ? 1 << 2 : 1 << 5;
+		return neg ? 1 << 1 : 1 << 6;
+	case FP_ZERO:
+		return neg ? 1 << 3 : 1 << 4;
+	case FP_NAN:
+		return (a & 0x0200) ? 1 << 9 : 1 << 8;
+	default:
+		return neg ? 1 << 2 : 1 << 5;
+	}
+}
+
+static void zfh_conversions(long cases)
+{
+	int rm, dp, n, ref_flags;
+	u64 a, ref;
+	u32 h;
+	long i;
+
+	/* fcvt.h.s and fcvt.h.d */
+	for (dp = 0; dp < 2; dp++)
+	for (rm = 0; rm < 4; rm++) {
+		for (i = 0; i < cases; i++) {
+			volatile float x;
+			volatile double y;
+
+			if (dp)
+				a = fp_test_rand_f64();
+			else
+				a = fp_test_rand_f32() | 0xFFFFFFFF00000000ULL;
+			FREG(1) = a;
+			tp = 0;
+			emulate(INSN_FCVT_H(dp, rm));
+
+			fesetround(host_rm[rm]);
+			feclearexcept(FE_ALL_EXCEPT);
+			if (dp) {
+				memcpy((void *)&y, &a, sizeof(a));
+				ref = host_h((_Float16)y);
+			} else {
+				memcpy((void *)&x, &a, sizeof(x));
+				ref = host_h((_Float16)x);
+			}
+			ref_flags = host_flags();
+			fesetround(FE_TONEAREST);
+			zfh_check(dp ? "fcvt.h.d" : "fcvt.h.s", rm, a, FREG(3),
+				  tp & 0x1F, F16_BOX | ref, ref_flags);
+		}
+	}
+
+	/* fcvt.h.<w|wu|l|lu>, rounding through f64 in the emulation */
+	for (n = 0; n < 4; n++)
+	for (rm = 0; rm < 4; rm++) {
+		static const char *name[4] = {
+			"fcvt.h.w", "fcvt.h.wu", "fcvt.h.l", "fcvt.h.lu"
+		};
+
+		for (i = 0; i < cases; i++) {
+			a = rand_int();
+			frame.regs.ra = a;
+			tp = 0;
+			emulate(INSN_FCVT_H_INT(n, rm));
+
+			fesetround(host_rm[rm]);
+			feclearexcept(FE_ALL_EXCEPT);
+			switch (n) {
+			case 0:
+				ref = host_h((_Float16)(s32)a);
+				break;
+			case 1:
+				ref = host_h((_Float16)(u32)a);
+				break;
+			case 2:
+				ref = host_h((_Float16)(s64)a);
+				break;
+			default:
+				ref = host_h((_Float16)a);
+				break;
+			}
+			ref_flags = host_flags();
+			fesetround(FE_TONEAREST);
+			zfh_check(name[n], rm, a, FREG(3), tp & 0x1F,
+				  F16_BOX | ref, ref_flags);
+		}
+	}
+
+	/* Every f16 value to S, D, integers and through fclass.h */
+	for (h = 0; h <= 0xFFFF; h++) {
+		static const char *name[4] = {
+			"fcvt.w.h", "fcvt.wu.h", "fcvt.l.h", "fcvt.lu.h"
+		};
+		volatile _Float16 x;
+		volatile float y;
+		volatile double z;
+		u32 r32;
+
+		a = F16_BOX | h;
+		memcpy((void *)&x, &h, sizeof(x));
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCVT_FROM_H(0));
+		feclearexcept(FE_ALL_EXCEPT);
+		y = x;
+		ref_flags = host_flags();
+		memcpy(&r32, (void *)&y, sizeof(r32));
+		if ((u32)(r32 << 1) > 0xFF000000U)
+			r32 = 0x7FC00000;
+		zfh_check("fcvt.s.h", 0, a, FREG(3), tp & 0x1F,
+			  0xFFFFFFFF00000000ULL | r32, ref_flags);
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCVT_FROM_H(1));
+		feclearexcept(FE_ALL_EXCEPT);
+		z = x;
+		ref_flags = host_flags();
+		memcpy(&ref, (void *)&z, sizeof(ref));
+		if ((ref << 1) > 0xFFE0000000000000ULL)
+			ref = 0x7FF8000000000000ULL;
+		zfh_check("fcvt.d.h", 0, a, FREG(3), tp & 0x1F, ref,
+			  ref_flags);
+
+		for (n = 0; n < 4; n++)
+		for (rm = 0; rm < 4; rm++) {
+			FREG(1) = a;
+			tp = 0;
+			emulate(INSN_FCVT_INT_H(n, rm));
+			ref = ref_fcvt_int_h(n, rm, h, &ref_flags);
+			zfh_check(name[n], rm, a, frame.regs.gp, tp & 0x1F,
+				  ref, ref_flags);
+		}
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCLASS_H);
+		zfh_check("fclass.h", 0, a, frame.regs.gp, tp & 0x1F,
+			  ref_fclass_h(h), 0);
+	}
+}
+
+/* An H operand that is not properly NaN-boxed reads as the canonical NaN */
+static void zfh_nan_boxing(long cases)
+{
+	u64 a, box;
+	long i;
+
+	for (i = 0; i < cases; i++) {
+		do {
+			box = fp_test_rand() & ~0xFFFFULL;
+		} while (box == F16_BOX);
+		a = box | (fp_test_rand() & 0xFFFF);
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCVT_FROM_H(0));
+		zfh_check("fcvt.s.h unboxed", 0, a, FREG(3), tp & 0x1F,
+			  0xFFFFFFFF7FC00000ULL, 0);
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCVT_FROM_H(1));
+		zfh_check("fcvt.d.h unboxed", 0, a, FREG(3), tp & 0x1F,
+			  0x7FF8000000000000ULL, 0);
+
+		FREG(1) = a;
+		tp = 0;
+		emulate(INSN_FCLASS_H);
+		zfh_check("fclass.h unboxed", 0, a, frame.regs.gp, tp & 0x1F,
+			  1 << 9, 0);
+	}
+}
+
+/* flh boxes the loaded value, fsh stores the low 16 bits unchecked */
+static void zfh_load_store(long cases)
+{
+	u16 mem[2];
+	long i;
+	u64 a;
+
+	for (i = 0; i < cases; i++) {
+		a = fp_test_rand();
+
+		mem[0] = a;
+		frame.regs.ra = (ulong)&mem[0];
+		FREG(3) = 0;
+		frame.regs.mepc = 0;
+		float_load_opcode_insn(INSN_FLH, &frame.regs);
+		zfh_check("flh", 0, a, FREG(3), frame.regs.mepc,
+			  F16_BOX | (u16)a, 4);
+
+		/* A faulting load leaves the destination alone */
+		host_fault_start = (ulong)&mem[0];
+		host_fault_end = host_fault_start + sizeof(mem[0]);
+		FREG(3) = a;
+		frame.regs.mepc = 0;
+		float_load_opcode_insn(INSN_FLH, &frame.regs);
+		host_fault_start = host_fault_end = 0;
+		zfh_check("flh fault", 0, a, FREG(3), frame.regs.mepc, a,
+			  HOST_STVEC);
+
+		mem[1] = ~a;
+		FREG(2) = a;
+		frame.regs.ra = (ulong)&mem[1];
+		frame.regs.mepc = 0;
+		float_store_opcode_insn(INSN_FSH, &frame.regs);
+		zfh_check("fsh", 0, a, mem[1], frame.regs.mepc, (u16)a, 4);
+	}
+}
+
+static long zfh(long cases)
+{
+	zfh_cases = zfh_bad = 0;
+	zfh_conversions(cases);
+	zfh_nan_boxing(cases);
+	zfh_load_store(cases);
+
+	printf("fp_emul: %ld zfh cases, %ld mismatches\n", zfh_cases,
+	       zfh_bad);
+	return zfh_bad;
+}
+
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+#define QHI(n)		(sbi_fp_qreg_hi()[n])
+
+/* fcvt.q.<s|d|w|wu|l|lu> and fcvt.<s|d>.q, rd and rs1 are f3 and f1/x1 */
+#define INSN_FCVT_Q(src, rm)	((0x23U << 25) | ((src) << 20) | \
+				 (1 << 15) | ((rm) << 12) | (3 << 7) | 0x53)
+#define INSN_FCVT_FROM_Q(dp, rm) ((((dp) ? 0x21U : 0x20U) << 25) | \
+				 (3 << 20) | (1 << 15) | ((rm) << 12) | \
+				 (3 << 7) | 0x53)
+#define INSN_FCVT_Q_INT(src)	((0x6BU << 25) | ((src) << 20) | \
+				 (1 << 15) | (3 << 7) | 0x53)
+#define INSN_FLQ		((1 << 15) | (4 << 12) | (3 << 7) | 0x07)
+#define INSN_FSQ		((3 << 20) | (2 << 15) | (4 << 12) | 0x27)
+
+static long q_cases, q_bad;
+
+/* Quad-precision values as {low, high} 64-bit halves */
+static void q_check(const char *name, int rm, const u64 *a, const u64 *b,
+		    const u64 *res, int emu_flags, const u64 *ref,
+		    int ref_flags)
+{
+	q_cases++;
+	emu_flags &= ~softfloat_flag_underflow;
+	ref_flags &= ~softfloat_flag_underflow;
+	if (res[0] == ref[0] && res[1] == ref[1] && emu_flags == ref_flags)
+		return;
+	if (q_bad++ < 10)
+		printf("%s rm=%d %016llx%016llx %016llx%016llx: "
+		       "%016llx%016llx/%02x expected %016llx%016llx/%02x\n",
+		       name, rm, (unsigned long long)a[1],
+		       (unsigned long long)a[0], (unsigned long long)b[1],
+		       (unsigned long long)b[0], (unsigned long long)res[1],
+		       (unsigned long long)res[0], emu_flags,
+		       (unsigned long long)ref[1], (unsigned long long)ref[0],
+		       ref_flags);
+}
+
+static void rand_f128(u64 *q)
+{
+	u64 r = fp_test_rand(), e = fp_test_rand();
+	u64 sign = r & 0x8000000000000000ULL, sig = r & 0x0000FFFFFFFFFFFFULL;
+
+	q[0] = fp_test_rand();
+	switch (e & 7) {
+	case 0:
+		q[1] = sign | sig;
+		break;
+	case 1:
+		q[0] = 0;
+		q[1] = sign | 0x7FFF000000000000ULL;
+		break;
+	case 2:
+		q[1] = r | 0x7FFF000000000000ULL;
+		break;
+	case 3:
+		q[1] = r;
+		break;
+	default:
+		q[1] = sign | sig | ((0x3FFF - 60 + (e >> 8) % 120) << 48);
+		break;
+	}
+}
+
+static void host_q(volatile __float128 z, u64 *q)
+{
+	memcpy(q, (void *)&z, 2 * sizeof(*q));
+	if ((q[1] & 0x7FFF000000000000ULL) == 0x7FFF000000000000ULL &&
+	    ((q[1] & 0x0000FFFFFFFFFFFFULL) || q[0])) {
+		q[0] = 0;
+		q[1] = 0x7FFF800000000000ULL;
+	}
+}
+
+static void set_q(int n, const u64 *q)
+{
+	FREG(n) = q[0];
+	QHI(n) = q[1];
+}
+
+static void get_q(int n, u64 *q)
+{
+	q[0] = FREG(n);
+	q[1] = QHI(n);
+}
+
+static void q_arith(long cases)
+{
+	u64 a[2], b[2], res[2], ref[2];
+	int op, rm, ref_flags;
+	long i;
+
+	for (op = 0; op < OP_SQRT; op++)
+	for (rm = 0; rm < 4; rm++) {
+		char name[8];
+
+		snprintf(name, sizeof(name), "%s.q", op_name[op]);
+		for (i = 0; i < cases; i++) {
+			volatile __float128 x, y, z;
+
+			rand_f128(a);
+			rand_f128(b);
+			set_q(1, a);
+			set_q(2, b);
+			tp = 0;
+			emulate(make_insn(op, 3, rm));
+			get_q(3, res);
+
+			memcpy((void *)&x, a, sizeof(a));
+			memcpy((void *)&y, b, sizeof(b));
+			fesetround(host_rm[rm]);
+			feclearexcept(FE_ALL_EXCEPT);
+			switch (op) {
+			case OP_ADD:
+				z = x + y;
+				break;
+			case OP_SUB:
+				z = x - y;
+				break;
+			case OP_MUL:
+				z = x * y;
+				break;
+			default:
+				z = x / y;
+				break;
+			}
+			ref_flags = host_flags();
+			fesetround(FE_TONEAREST);
+			host_q(z, ref);
+			q_check(name, rm, a, b, res, tp & 0x1F, ref, ref_flags);
+		}
+	}
+}
+
+static void q_conversions(long cases)
+{
+	static const char *int_name[4] = {
+		"fcvt.q.w", "fcvt.q.wu", "fcvt.q.l", "fcvt.q.lu"
+	};
+	u64 a[2], none[2] = { 0, 0 }, res[2], ref[2];
+	int dp, n, rm, ref_flags;
+	long i;
+
+	/* fcvt.q.s and fcvt.q.d are exact, fcvt.s.q and fcvt.d.q round */
+	for (dp = 0; dp < 2; dp++)
+	for (rm = 0; rm < 4; rm++) {
+		for (i = 0; i < cases; i++) {
+			volatile __float128 q;
+			volatile double y;
+			volatile float x;
+
+			if (dp) {
+				a[0] = fp_test_rand_f64();
+				memcpy((void *)&y, &a[0], sizeof(a[0]));
+			} else {
+				a[0] = fp_test_rand_f32() |
+				       0xFFFFFFFF00000000ULL;
+				memcpy((void *)&x, &a[0], sizeof(x));
+			}
+			a[1] = 0;
+			FREG(1) = a[0];
+			tp = 0;
+			emulate(INSN_FCVT_Q(dp, rm));
+			get_q(3, res);
+			feclearexcept(FE_ALL_EXCEPT);
+			host_q(dp ? (__float128)y : (__float128)x, ref);
+			ref_flags = host_flags();
+			q_check(dp ? "fcvt.q.d" : "fcvt.q.s", rm, a, none, res,
+				tp & 0x1F, ref, ref_flags);
+
+			rand_f128(a);
+			set_q(1, a);
+			tp = 0;
+			emulate(INSN_FCVT_FROM_Q(dp, rm));
+			get_q(3, res);
+			memcpy((void *)&q, a, sizeof(a));
+			fesetround(host_rm[rm]);
+			feclearexcept(FE_ALL_EXCEPT);
+			if (dp) {
+				y = q;
+				memcpy(&ref[0], (void *)&y, sizeof(ref[0]));
+				if ((ref[0] << 1) > 0xFFE0000000000000ULL)
+					ref[0] = 0x7FF8000000000000ULL;
+			} else {
+				u32 r32;
+
+				x = q;
+				memcpy(&r32, (void *)&x, sizeof(r32));
+				if ((u32)(r32 << 1) > 0xFF000000U)
+					r32 = 0x7FC00000;
+				ref[0] = 0xFFFFFFFF00000000ULL | r32;
+			}
+			ref_flags = host_flags();
+			fesetround(FE_TONEAREST);
+			/* Narrower results NaN-box the high half */
+			ref[1] = -1ULL;
+			q_check(dp ? "fcvt.d.q" : "fcvt.s.q", rm, a, none, res,
+				tp & 0x1F, ref, ref_flags);
+		}
+	}
+
+	/* Every 32 and 64-bit integer is exact in Q */
+	for (n = 0; n < 4; n++) {
+		for (i = 0; i < cases; i++) {
+			a[0] = rand_int();
+			a[1] = 0;
+			frame.regs.ra = a[0];
+			tp = 0;
+			emulate(INSN_FCVT_Q_INT(n));
+			get_q(3, res);
+			feclearexcept(FE_ALL_EXCEPT);
+			switch (n) {
+			case 0:
+				host_q((s32)a[0], ref);
+				break;
+			case 1:
+				host_q((u32)a[0], ref);
+				break;
+			case 2:
+				host_q((s64)a[0], ref);
+				break;
+			default:
+				host_q(a[0], ref);
+				break;
+			}
+			ref_flags = host_flags();
+			q_check(int_name[n], 0, a, none, res, tp & 0x1F, ref,
+				ref_flags);
+		}
+	}
+}
+
+/* flq followed by fsq copies all 128 bits */
+static void q_load_store(long cases)
+{
+	u64 src[2], dst[2], none[2] = { 0, 0 }, res[2];
+	long i;
+
+	for (i = 0; i < cases; i++) {
+		src[0] = fp_test_rand();
+		src[1] = fp_test_rand();
+		dst[0] = ~src[0];
+		dst[1] = ~src[1];
+		frame.regs.ra = (ulong)src;
+		frame.regs.sp = (ulong)dst;
+
+		frame.regs.mepc = 0;
+		float_load_opcode_insn(INSN_FLQ, &frame.regs);
+		get_q(3, res);
+		q_check("flq", 0, src, none, res, frame.regs.mepc, src, 4);
+
+		frame.regs.mepc = 0;
+		float_store_opcode_insn(INSN_FSQ, &frame.regs);
+		q_check("fsq", 0, src, none, dst, frame.regs.mepc, src, 4);
+	}
+}
+
+static long quad(long cases)
+{
+	q_cases = q_bad = 0;
+	q_arith(cases);
+	q_conversions(cases);
+	q_load_store(cases);
+
+	printf("fp_emul: %ld q cases, %ld mismatches\n", q_cases, q_bad);
+	return q_bad;
+}
+#endif
+
+static void benchmark(void)
+{
+	int dp, op, k;
+	long i, n = 2000000;
+	double t, best;
+	char name[16];
+
+	for (dp = 0; dp < 2; dp++)
+	for (op = 0; op < OP_MAX; op++) {
+		/* Normal operands, dynamic rounding mode set to RNE */
+		u32 insn = make_insn(op, dp, 7);
+
+		FREG(1) = dp ? 0x3FF3C0CA428C59FBULL : 0xFFFFFFFF3F9E0652ULL;
+		FREG(2) = dp ? 0x3FF1E3779B97F4A8ULL : 0xFFFFFFFF3F8F1BBDULL;
+		tp = 0;
+		best = 1e30;
+		for (k = 0; k < 5; k++) {
+			t = fp_test_now_ns();
+			for (i = 0; i < n; i++)
+				emulate(insn);
+			t = (fp_test_now_ns() - t) / n;
+			if (t < best)
+				best = t;
+		}
+		snprintf(name, sizeof(name), "%s.%c", op_name[op],
+			 dp ? 'd' : 's');
+		printf("%-8s %6.2f ns/insn\n", name, best);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	long cases = 200000;
+	int i, bench = 0;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-b"))
+			bench = 1;
+		else
+			cases = atol(argv[i]);
+	}
+
+	host_init();
+	frame.regs.mstatus = MSTATUS_FS;
+
+	if (bench) {
+		benchmark();
+		return 0;
+	}
+
+	if (conformance(cases) | zfh(cases))
+		return 1;
+#ifdef SBI_ENABLE_FP_EMULATION_Q
+	if (quad(cases))
+		return 1;
+#endif
+
+	return 0;
+}
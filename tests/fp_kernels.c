@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+/*
+ * Differential test and benchmark of the fast FP kernels against the
+ * softfloat routines they replace. Results and accrued flags must be
+ * identical for every operand and rounding mode. As in the emulation,
+ * tp holds the accrued flags and the rounding mode in bits 13-15.
+ *
+ * Usage: fp_kernels [-b] [-x] [cases]
+ *   -b  benchmark the kernels and softfloat on normal operands
+ *   -x  also test f32 square root exhaustively in every rounding mode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sbi_utils/softfloat/softfloat.h>
+#include <sbi/sbi_fp_kernels.h>
+#include "fp_test.h"
+
+long tp;
+
+static long bad;
+
+static void check(const char *name, u64 a, u64 b, long tp0,
+		  u64 res, long res_tp, u64 ref, long ref_tp)
+{
+	if (res == ref && res_tp == ref_tp)
+		return;
+	if (bad++ < 20)
+		printf("%s %016llx %016llx tp=%04lx: %016llx/%04lx "
+		       "expected %016llx/%04lx\n", name, (unsigned long long)a,
+		       (unsigned long long)b, tp0, (unsigned long long)res,
+		       res_tp, (unsigned long long)ref, ref_tp);
+}
+
+#define CHECK2(fast, ref, T, x, y)					\
+do {									\
+	T __a = { .v = (x) }, __b = { .v = (y) }, __r1, __r2;		\
+	long __f1, __f2;						\
+	tp = tp0;							\
+	__r1 = fast(__a, __b);						\
+	__f1 = tp;							\
+	tp = tp0;							\
+	__r2 = ref(__a, __b);						\
+	__f2 = tp;							\
+	check(#fast, __a.v, __b.v, tp0, __r1.v, __f1, __r2.v, __f2); \
+} while (0)
+
+#define CHECK1(fast, ref, T, x)						\
+do {									\
+	T __a = { .v = (x) }, __r1, __r2;				\
+	long __f1, __f2;						\
+	tp = tp0;							\
+	__r1 = fast(__a);						\
+	__f1 = tp;							\
+	tp = tp0;							\
+	__r2 = ref(__a);						\
+	__f2 = tp;							\
+	check(#fast, __a.v, 0, tp0, __r1.v, __f1, __r2.v, __f2);	\
+} while (0)
+
+static void random_cases(long cases)
+{
+	u64 a, b, m, k;
+	u32 c, d;
+	long i, tp0;
+	int rm;
+
+	for (i = 0; i < cases; i++) {
+		/* Mostly RNE, the only mode add and mul accelerate */
+		rm = fp_test_rand() % 8;
+		if (rm > 4)
+			rm = 0;
+		/* Some cases start with accrued flags already set */
+		tp0 = ((long)rm << 13) | (fp_test_rand() & 0x1F &
+					  -(long)(fp_test_rand() & 1));
+		a = fp_test_rand_f64();
+		b = fp_test_rand_f64();
+		c = fp_test_rand_f32();
+		d = fp_test_rand_f32();
+
+		CHECK2(fp_fast_f64_add, f64_add, float64_t, a, b);
+		CHECK2(fp_fast_f64_mul, f64_mul, float64_t, a, b);
+		CHECK2(fp_fast_f32_add, f32_add, float32_t, c, d);
+		CHECK2(fp_fast_f32_mul, f32_mul, float32_t, c, d);
+		CHECK2(fp_fast_f64_div, f64_div, float64_t, a, b);
+		CHECK2(fp_fast_f32_div, f32_div, float32_t, c, d);
+		CHECK1(fp_fast_f64_sqrt, f64_sqrt, float64_t, a);
+		CHECK1(fp_fast_f32_sqrt, f32_sqrt, float32_t, c);
+
+		/* Exact quotients and perfect squares, built with softfloat */
+		tp = 0;
+		m = ui64_to_f64((fp_test_rand() & 0x1FFFFFF) | 1).v;
+		k = ui64_to_f64((fp_test_rand() & 0xFFFFFFF) | 1).v;
+		a = f64_mul((float64_t){ m }, (float64_t){ k }).v;
+		b = f64_mul((float64_t){ m }, (float64_t){ m }).v;
+		c = ui32_to_f32((fp_test_rand() & 0xFFF) | 1).v;
+		c = f32_mul((float32_t){ c }, (float32_t){ c }).v;
+		CHECK2(fp_fast_f64_div, f64_div, float64_t, a, k);
+		CHECK1(fp_fast_f64_sqrt, f64_sqrt, float64_t, b);
+		CHECK1(fp_fast_f32_sqrt, f32_sqrt, float32_t, c);
+	}
+
+	printf("fp_kernels: %ld random cases\n", cases * 11);
+}
+
+static void exhaustive_f32_sqrt(void)
+{
+	long tp0;
+	u64 x;
+	int rm;
+
+	for (rm = 0; rm < 5; rm++) {
+		tp0 = (long)rm << 13;
+		for (x = 0; x <= 0xFFFFFFFF; x++)
+			CHECK1(fp_fast_f32_sqrt, f32_sqrt, float32_t, x);
+		printf("fp_kernels: f32_sqrt rm=%d exhaustive\n", rm);
+	}
+}
+
+#define BENCH_N		4096
+
+static u64 bench_a[BENCH_N], bench_b[BENCH_N];
+static u32 bench_c[BENCH_N], bench_d[BENCH_N];
+
+#define BENCH(name, expr)						\
+do {									\
+	double __t, __best = 1e30;					\
+	int __k, __r, i;						\
+	for (__k = 0; __k < 5; __k++) {					\
+		__t = fp_test_now_ns();					\
+		for (__r = 0; __r < 100; __r++)				\
+			for (i = 0; i < BENCH_N; i++) {			\
+				tp = 0;					\
+				sink += (expr).v;			\
+			}						\
+		__t = (fp_test_now_ns() - __t) / (100.0 * BENCH_N);	\
+		if (__t < __best)					\
+			__best = __t;					\
+	}								\
+	printf("%-18s %6.2f ns/op\n", name, __best);			\
+} while (0)
+
+#define BENCH1(fn, T, x)	BENCH(#fn, fn((T){ x[i] }))
+#define BENCH2(fn, T, x, y)	BENCH(#fn, fn((T){ x[i] }, (T){ y[i] }))
+
+static void benchmark(void)
+{
+	volatile u64 sink = 0;
+	u64 r;
+	int i;
+
+	/* Normal operands within a few binades of 1.0 */
+	for (i = 0; i < BENCH_N; i++) {
+		r = fp_test_rand();
+		bench_a[i] = (r & 0x800FFFFFFFFFFFFFULL) |
+			     ((0x3FF - 32 + (r >> 52) % 64) << 52);
+		r = fp_test_rand();
+		bench_b[i] = (r & 0x000FFFFFFFFFFFFFULL) |
+			     ((0x3FF - 32 + (r >> 52) % 64) << 52);
+		bench_c[i] = f64_to_f32((float64_t){ bench_a[i] }).v;
+		bench_d[i] = f64_to_f32((float64_t){ bench_b[i] }).v;
+	}
+
+	BENCH2(f64_add, float64_t, bench_a, bench_b);
+	BENCH2(fp_fast_f64_add, float64_t, bench_a, bench_b);
+	BENCH2(f64_mul, float64_t, bench_a, bench_b);
+	BENCH2(fp_fast_f64_mul, float64_t, bench_a, bench_b);
+	BENCH2(f64_div, float64_t, bench_a, bench_b);
+	BENCH2(fp_fast_f64_div, float64_t, bench_a, bench_b);
+	BENCH1(f64_sqrt, float64_t, bench_b);
+	BENCH1(fp_fast_f64_sqrt, float64_t, bench_b);
+	BENCH2(f32_add, float32_t, bench_c, bench_d);
+	BENCH2(fp_fast_f32_add, float32_t, bench_c, bench_d);
+	BENCH2(f32_mul, float32_t, bench_c, bench_d);
+	BENCH2(fp_fast_f32_mul, float32_t, bench_c, bench_d);
+	BENCH2(f32_div, float32_t, bench_c, bench_d);
+	BENCH2(fp_fast_f32_div, float32_t, bench_c, bench_d);
+	BENCH1(f32_sqrt, float32_t, bench_d);
+	BENCH1(fp_fast_f32_sqrt, float32_t, bench_d);
+}
+
+int main(int argc, char **argv)
+{
+	int i, bench = 0, exhaustive = 0;
+	long cases = 1000000;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-b"))
+			bench = 1;
+		else if (!strcmp(argv[i], "-x"))
+			exhaustive = 1;
+		else
+			cases = atol(argv[i]);
+	}
+
+	if (bench) {
+		benchmark();
+		return 0;
+	}
+
+	random_cases(cases);
+	if (exhaustive)
+		exhaustive_f32_sqrt();
+	printf("fp_kernels: %ld mismatches\n", bad);
+
+	return bad ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+/*
+ * Test of the FP run-ahead emulation. Each case places a short sequence
+ * of instructions in host memory, emulates the run starting with its
+ * first instruction and checks where the run stopped and the registers
+ * it left behind.
+ *
+ * Usage: fp_run
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_fp_emulation.h>
+#include <sbi/sbi_fp_run.h>
+#include "sbi_host.h"
+
+#define INSN_FSFLAGS_A5		0x00179073	/* csrrw x0, fflags, a5 */
+#define INSN_FSCSR_A0		0x00351073	/* csrrw x0, fcsr, a0 */
+#define INSN_FEQ_S_X0		0xa0b5a053	/* feq.s x0, fa1, fa1 */
+#define INSN_LI_A1_5		0x00500593	/* addi a1, x0, 5 */
+#define INSN_FMV_W_X_FA0	0xf0000553	/* fmv.w.x fa0, x0 */
+#define INSN_FADD_S		0x00b57553	/* fadd.s fa0, fa0, fa1 */
+#define INSN_C_FLD_FS0		0x2100		/* c.fld fs0, 0(a0) */
+#define INSN_C_FLDSP_FS1	0x2482		/* c.fldsp fs1, 0(sp) */
+#define INSN_ECALL		0x00000073
+
+static union {
+	struct sbi_trap_regs regs;
+	u8 bytes[SBI_TRAP_REGS_SIZE];
+} frame;
+
+#define FREG(n)	(((u64 *)&frame.bytes[SBI_TRAP_REGS_OFFSET(last)])[n])
+
+/* Two pages of code, runs may cross from the first into the second */
+static u8 code[2 * PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));
+
+static long bad;
+
+#define CHECK(name, cond)						\
+	do {								\
+		if (!(cond)) {						\
+			printf("%s: %s failed\n", name, #cond);		\
+			bad++;						\
+		}							\
+	} while (0)
+
+static void reset(void)
+{
+	host_init();
+	memset(code, 0, sizeof(code));
+	memset(&frame, 0, sizeof(frame));
+	frame.regs.mstatus = MSTATUS_FS | (PRV_S << MSTATUS_MPP_SHIFT);
+	tp = 0;
+}
+
+/* Emulate the run of the count instructions placed at offset off */
+static void run(ulong off, const u32 *insns, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		memcpy(&code[off + 4 * i], &insns[i], sizeof(insns[i]));
+	frame.regs.mepc = (ulong)&code[off];
+	sbi_fp_emulate_run(insns[0], &frame.regs, 0);
+}
+
+/* The old FCSR value written to x0 must not be read back as x0 */
+static void test_rd_x0(const char *name, u32 first)
+{
+	const u32 insns[] = {
+		first, INSN_LI_A1_5, INSN_FMV_W_X_FA0, INSN_ECALL
+	};
+
+	reset();
+	tp = 0x15;
+	frame.regs.a0 = 0x1f;
+	frame.regs.a5 = 0x1f;
+	FREG(11) = 0xffffffff3f800000ULL;
+	run(0, insns, 4);
+	CHECK(name, frame.regs.mepc == (ulong)&code[12]);
+	CHECK(name, frame.regs.zero == 0);
+	CHECK(name, frame.regs.a1 == 5);
+	CHECK(name, FREG(10) == 0xffffffff00000000ULL);
+}
+
+/* A run must not fetch instructions from another page */
+static void test_page_end(void)
+{
+	const u32 insns[] = { INSN_FADD_S, INSN_FADD_S, INSN_FADD_S };
+
+	reset();
+	run(PAGE_SIZE - 8, insns, 3);
+	CHECK("page end", frame.regs.mepc == (ulong)&code[PAGE_SIZE]);
+
+	/* The second instruction straddles the end of the page */
+	reset();
+	run(PAGE_SIZE - 6, insns, 3);
+	CHECK("page straddle", frame.regs.mepc == (ulong)&code[PAGE_SIZE - 2]);
+
+	reset();
+	run(PAGE_SIZE - 16, insns, 3);
+	CHECK("page interior", frame.regs.mepc == (ulong)&code[PAGE_SIZE - 4]);
+}
+
+/* Compressed loads, a faulting one must leave its destination unchanged */
+static void test_c_fld(const char *name, u32 insn, int rd)
+{
+	u64 data = 0x400921fb54442d18ULL;
+
+	reset();
+	frame.regs.a0 = (ulong)&data;
+	frame.regs.sp = (ulong)&data;
+	FREG(rd) = 0x3ff0000000000000ULL;
+	run(0, &insn, 1);
+	CHECK(name, frame.regs.mepc == (ulong)&code[2]);
+	CHECK(name, FREG(rd) == data);
+
+	reset();
+	frame.regs.a0 = (ulong)&data;
+	frame.regs.sp = (ulong)&data;
+	FREG(rd) = 0x3ff0000000000000ULL;
+	host_fault_start = (ulong)&data;
+	host_fault_end = host_fault_start + sizeof(data);
+	run(0, &insn, 1);
+	CHECK(name, frame.regs.mepc == HOST_STVEC);
+	CHECK(name, host_trap.cause == CAUSE_LOAD_ACCESS);
+	CHECK(name, FREG(rd) == 0x3ff0000000000000ULL);
+}
+
+int main(int argc, char **argv)
+{
+	test_rd_x0("fsflags x0", INSN_FSFLAGS_A5);
+	test_rd_x0("fscsr x0", INSN_FSCSR_A0);
+	test_rd_x0("feq.s x0", INSN_FEQ_S_X0);
+	test_page_end();
+	test_c_fld("c.fld", INSN_C_FLD_FS0, 8);
+	test_c_fld("c.fldsp", INSN_C_FLDSP_FS1, 9);
+
+	printf("fp_run: %ld failures\n", bad);
+	return bad ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __FP_TEST_H__
+#define __FP_TEST_H__
+
+#include <stdint.h>
+#include <time.h>
+
+/* Fixed seed, so that a failing case can be reproduced */
+static uint64_t fp_test_state = 88172645463325252ULL;
+
+static inline uint64_t fp_test_rand(void)
+{
+	fp_test_state ^= fp_test_state << 13;
+	fp_test_state ^= fp_test_state >> 7;
+	fp_test_state ^= fp_test_state << 17;
+	return fp_test_state;
+}
+
+/*
+ * Random operands biased towards the interesting cases: zeros and
+ * subnormals, infinities and NaNs, values next to the smallest and
+ * largest normals and significands right next to a power of two.
+ */
+static inline uint64_t fp_test_rand_f64(void)
+{
+	uint64_t r = fp_test_rand(), sign = r & 0x8000000000000000ULL;
+	uint64_t sig = r & 0x000FFFFFFFFFFFFFULL, e = fp_test_rand();
+
+	switch (e & 15) {
+	case 0:
+		return sign | sig;
+	case 1:
+		return sign | 0x7FF0000000000000ULL;
+	case 2:
+		return r | 0x7FF0000000000000ULL;
+	case 3:
+		return sign | sig | ((1 + (e >> 8) % 4) << 52);
+	case 4:
+		return sign | sig | ((0x7FE - (e >> 8) % 4) << 52);
+	case 5:
+		return sign | ((0x3FF - 4 + (e >> 8) % 8) << 52) | (sig & 0xF);
+	case 6:
+		return sign | ((0x3FF - 4 + (e >> 8) % 8) << 52) |
+		       (0x000FFFFFFFFFFFFFULL - (sig & 0xF));
+	case 7:
+		return r;
+	default:
+		return sign | sig | ((0x3FF - 60 + (e >> 8) % 120) << 52);
+	}
+}
+
+static inline uint32_t fp_test_rand_f32(void)
+{
+	uint64_t e = fp_test_rand();
+	uint32_t r = fp_test_rand(), sign = r & 0x80000000, sig = r & 0x7FFFFF;
+
+	switch (e & 15) {
+	case 0:
+		return sign | sig;
+	case 1:
+		return sign | 0x7F800000;
+	case 2:
+		return r | 0x7F800000;
+	case 3:
+		return sign | sig | ((1 + (e >> 8) % 4) << 23);
+	case 4:
+		return sign | sig | ((0xFE - (e >> 8) % 4) << 23);
+	case 5:
+		return sign | ((0x7F - 4 + (e >> 8) % 8) << 23) | (sig & 0xF);
+	case 6:
+		return sign | ((0x7F - 4 + (e >> 8) % 8) << 23) |
+		       (0x7FFFFF - (sig & 0xF));
+	case 7:
+		return r;
+	default:
+		return sign | sig | ((0x7F - 30 + (e >> 8) % 60) << 23);
+	}
+}
+
+static inline double fp_test_now_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+/* Host replacement of the RISC-V atomics for tests built on the host */
+
+#ifndef __RISCV_ATOMIC_H__
+#define __RISCV_ATOMIC_H__
+
+typedef struct {
+	volatile long counter;
+} atomic_t;
+
+#define ATOMIC_INIT(_lptr, val) (_lptr)->counter = (val)
+
+#define ATOMIC_INITIALIZER(val)   \
+	{                         \
+		.counter = (val), \
+	}
+
+static inline long atomic_read(atomic_t *atom)
+{
+	return __atomic_load_n(&atom->counter, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_write(atomic_t *atom, long value)
+{
+	__atomic_store_n(&atom->counter, value, __ATOMIC_RELAXED);
+}
+
+static inline long atomic_add_return(atomic_t *atom, long value)
+{
+	return __atomic_add_fetch(&atom->counter, value, __ATOMIC_SEQ_CST);
+}
+
+static inline long atomic_sub_return(atomic_t *atom, long value)
+{
+	return __atomic_sub_fetch(&atom->counter, value, __ATOMIC_SEQ_CST);
+}
+
+static inline long atomic_cmpxchg(atomic_t *atom, long oldval, long newval)
+{
+	__atomic_compare_exchange_n(&atom->counter, &oldval, newval, 0,
+				    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return oldval;
+}
+
+static inline long atomic_xchg(atomic_t *atom, long newval)
+{
+	return __atomic_exchange_n(&atom->counter, newval, __ATOMIC_SEQ_CST);
+}
+
+#endif
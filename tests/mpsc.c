@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+/*
+ * Stress test of the MPSC queue. Producer threads stand in for the HARTs
+ * sending TLB requests and the main thread for the receiving HART. The
+ * queue is kept small so that it is full most of the time. Each producer
+ * must see its entries dequeued exactly once, in order and untorn.
+ *
+ * Usage: mpsc [producers] [entries per producer]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sbi/sbi_mpsc.h>
+
+#define MPSC_TEST_ENTRIES	8
+#define MPSC_TEST_MAX_PROD	64
+
+struct mpsc_test_entry {
+	unsigned long producer;
+	unsigned long seq;
+	unsigned long check;
+};
+
+static struct sbi_mpsc queue;
+static unsigned char queue_mem[MPSC_TEST_ENTRIES *
+			       SBI_MPSC_SLOT_SIZE(sizeof(struct mpsc_test_entry))];
+static unsigned long per_producer = 200000;
+
+static void *producer(void *arg)
+{
+	struct mpsc_test_entry e = { .producer = (unsigned long)arg };
+
+	for (e.seq = 0; e.seq < per_producer; e.seq++) {
+		e.check = ~(e.producer ^ e.seq);
+		while (sbi_mpsc_enqueue(&queue, &e))
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long next[MPSC_TEST_MAX_PROD] = { 0 };
+	unsigned long i, nprod = 8, got = 0, bad = 0;
+	pthread_t threads[MPSC_TEST_MAX_PROD];
+	struct mpsc_test_entry e;
+
+	if (argc > 1)
+		nprod = strtoul(argv[1], NULL, 0);
+	if (argc > 2)
+		per_producer = strtoul(argv[2], NULL, 0);
+	if (!nprod || nprod > MPSC_TEST_MAX_PROD)
+		return 2;
+
+	if (sbi_mpsc_init(&queue, queue_mem, MPSC_TEST_ENTRIES, sizeof(e)))
+		return 2;
+	for (i = 0; i < nprod; i++)
+		pthread_create(&threads[i], NULL, producer, (void *)i);
+
+	while (got < nprod * per_producer) {
+		if (sbi_mpsc_dequeue(&queue, &e)) {
+			sched_yield();
+			continue;
+		}
+		got++;
+		if (e.producer >= nprod || e.check != ~(e.producer ^ e.seq) ||
+		    e.seq != next[e.producer]) {
+			if (bad++ < 10)
+				printf("mpsc: producer %lu seq %lu check %lx\n",
+				       e.producer, e.seq, e.check);
+			if (e.producer >= nprod)
+				continue;
+		}
+		next[e.producer] = e.seq + 1;
+	}
+
+	for (i = 0; i < nprod; i++)
+		pthread_join(threads[i], NULL);
+	if (!sbi_mpsc_dequeue(&queue, &e))
+		bad++;
+
+	printf("mpsc: %lu producers, %lu entries, %lu errors\n", nprod, got,
+	       bad);
+	return bad ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_fp_qreg.h>
+#include <sbi/sbi_fp_run.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_misaligned_ldst.h>
+#include <sbi/sbi_pmu.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_unpriv.h>
+#include "sbi_host.h"
+
+long tp;
+
+ulong host_fault_start, host_fault_end;
+struct sbi_trap_info host_trap;
+unsigned long host_csrs[4096];
+
+static union {
+	struct sbi_scratch scratch;
+	u8 bytes[SBI_SCRATCH_SIZE];
+} host_scratch __attribute__((aligned(64)));
+static unsigned long host_scratch_next = SBI_SCRATCH_EXTRA_SPACE_OFFSET;
+
+unsigned long csr_read_num(int csr_num)
+{
+	return host_csrs[csr_num & 0xfff];
+}
+
+void csr_write_num(int csr_num, unsigned long val)
+{
+	host_csrs[csr_num & 0xfff] = val;
+}
+
+unsigned long sbi_scratch_alloc_offset(unsigned long size)
+{
+	unsigned long ret = host_scratch_next;
+
+	size = (size + sizeof(long) - 1) & ~(sizeof(long) - 1);
+	if (SBI_SCRATCH_SIZE - ret < size)
+		return 0;
+	host_scratch_next += size;
+
+	return ret;
+}
+
+void host_init(void)
+{
+	static bool cold_boot = TRUE;
+
+	host_csrs[CSR_MSCRATCH] = (unsigned long)&host_scratch.scratch;
+	host_fault_start = host_fault_end = 0;
+	sbi_memset(&host_trap, 0, sizeof(host_trap));
+	sbi_fp_icache_init(&host_scratch.scratch, cold_boot);
+	sbi_fp_qreg_init(&host_scratch.scratch, cold_boot);
+	cold_boot = FALSE;
+}
+
+static bool host_fault(const void *addr, ulong len, ulong cause,
+		       struct sbi_trap_info *trap)
+{
+	ulong start = (ulong)addr;
+
+	trap->cause = 0;
+	if (start + len <= host_fault_start || host_fault_end <= start)
+		return FALSE;
+	trap->cause = cause;
+	trap->tval = start;
+	trap->tval2 = 0;
+	trap->tinst = 0;
+
+	return TRUE;
+}
+
+#define DEFINE_HOST_LOAD_FUNCTION(type)					\
+	type sbi_load_##type(const type *addr,				\
+			     struct sbi_trap_info *trap)		\
+	{								\
+		type val = 0;						\
+									\
+		if (!host_fault(addr, sizeof(type), CAUSE_LOAD_ACCESS,	\
+				trap))					\
+			sbi_memcpy(&val, addr, sizeof(type));		\
+		return val;						\
+	}
+
+#define DEFINE_HOST_STORE_FUNCTION(type)				\
+	void sbi_store_##type(type *addr, type val,			\
+			      struct sbi_trap_info *trap)		\
+	{								\
+		if (!host_fault(addr, sizeof(type), CAUSE_STORE_ACCESS,	\
+				trap))					\
+			sbi_memcpy(addr, &val, sizeof(type));		\
+	}
+
+DEFINE_HOST_LOAD_FUNCTION(u16)
+DEFINE_HOST_LOAD_FUNCTION(s32)
+DEFINE_HOST_LOAD_FUNCTION(u64)
+DEFINE_HOST_STORE_FUNCTION(u16)
+DEFINE_HOST_STORE_FUNCTION(u32)
+DEFINE_HOST_STORE_FUNCTION(u64)
+
+ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
+{
+	u16 lo, hi = 0;
+
+	if (host_fault((void *)mepc, 2, CAUSE_FETCH_ACCESS, trap))
+		return 0;
+	sbi_memcpy(&lo, (void *)mepc, sizeof(lo));
+	if ((lo & 3) == 3) {
+		if (host_fault((void *)(mepc + 2), 2, CAUSE_FETCH_ACCESS,
+			       trap))
+			return 0;
+		sbi_memcpy(&hi, (void *)(mepc + 2), sizeof(hi));
+	}
+
+	return ((ulong)hi << 16) | lo;
+}
+
+int sbi_trap_redirect(struct sbi_trap_regs *regs, struct sbi_trap_info *trap)
+{
+	host_trap = *trap;
+	regs->mepc = HOST_STVEC;
+
+	return 0;
+}
+
+int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
+				struct sbi_trap_regs *regs)
+{
+	struct sbi_trap_info trap = {
+		.epc = regs->mepc,
+		.cause = CAUSE_MISALIGNED_LOAD,
+		.tval = addr,
+	};
+
+	return sbi_trap_redirect(regs, &trap);
+}
+
+int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
+				 struct sbi_trap_regs *regs)
+{
+	struct sbi_trap_info trap = {
+		.epc = regs->mepc,
+		.cause = CAUSE_MISALIGNED_STORE,
+		.tval = addr,
+	};
+
+	return sbi_trap_redirect(regs, &trap);
+}
+
+int sbi_pmu_ctr_incr_fw(enum sbi_pmu_fw_event_code_id fw_id)
+{
+	return 0;
+}
+
+int sbi_pmu_ctr_add_fw(enum sbi_pmu_fw_event_code_id fw_id, unsigned long val)
+{
+	return 0;
+}
+
+bool sbi_hart_has_feature(struct sbi_scratch *scratch, unsigned long feature)
+{
+	return FALSE;
+}
+
+unsigned int sbi_hart_mhpm_count(struct sbi_scratch *scratch)
+{
+	return 0;
+}
+
+u64 sbi_timer_value(void)
+{
+	return 0;
+}
+
+u64 sbi_timer_virt_value(void)
+{
+	return 0;
+}
+
+u64 sbi_timer_get_delta(void)
+{
+	return 0;
+}
+
+void sbi_timer_set_delta(ulong delta)
+{
+}
+
+int sbi_dprintf(const char *format, ...)
+{
+	return 0;
+}
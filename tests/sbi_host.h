@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ */
+
+#ifndef __SBI_HOST_H__
+#define __SBI_HOST_H__
+
+#include <sbi/sbi_trap.h>
+#include <sbi/sbi_types.h>
+
+/*
+ * Host stand-ins for the firmware services used by the trap emulation.
+ * S/U-mode addresses are host pointers. Loads, stores and fetches within
+ * [host_fault_start, host_fault_end) raise an access fault instead.
+ */
+extern ulong host_fault_start, host_fault_end;
+
+/* Last trap redirected to S-mode, cleared by host_init() */
+extern struct sbi_trap_info host_trap;
+
+/* Address that a redirected trap sets mepc to */
+#define HOST_STVEC	0x1000UL
+
+/* CSR values returned by csr_read() */
+extern unsigned long host_csrs[4096];
+
+/* Set up the CSRs, the scratch space of the HART and the FP emulation */
+void host_init(void);
+
+#endif